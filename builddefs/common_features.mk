@@ -47,6 +47,34 @@ else ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), api)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
 endif
 
+ifeq ($(strip $(TASK_PROFILER_ENABLE)), yes)
+    OPT_DEFS += -DTASK_PROFILER_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/task_profiler.c
+endif
+
+ifeq ($(strip $(SCAN_LATENCY_ENABLE)), yes)
+    OPT_DEFS += -DSCAN_LATENCY_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/scan_latency.c
+endif
+
+ifeq ($(strip $(RENDER_THREAD_ENABLE)), yes)
+    ifneq ($(PLATFORM),CHIBIOS)
+        $(call CATASTROPHIC_ERROR,Invalid RENDER_THREAD_ENABLE,RENDER_THREAD_ENABLE is only supported on ChibiOS)
+    endif
+    ifeq ($(strip $(TASK_SCHEDULER_ENABLE)), yes)
+        $(call CATASTROPHIC_ERROR,Invalid RENDER_THREAD_ENABLE,RENDER_THREAD_ENABLE and TASK_SCHEDULER_ENABLE cannot be used together)
+    endif
+    OPT_DEFS += -DRENDER_THREAD_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/render_thread.c
+    SRC += $(PLATFORM_COMMON_DIR)/render_thread.c
+endif
+
+ifeq ($(strip $(TASK_SCHEDULER_ENABLE)), yes)
+    OPT_DEFS += -DTASK_SCHEDULER_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/task_scheduler.c
+    DEFERRED_EXEC_ENABLE := yes
+endif
+
 AUDIO_ENABLE ?= no
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     ifeq ($(PLATFORM),CHIBIOS)
@@ -585,6 +613,15 @@ ifneq ($(strip $(VARIABLE_TRACE)),no)
     endif
 endif
 
+ifeq ($(strip $(MATRIX_IDLE_SLEEP_ENABLE)), yes)
+    ifneq ($(PLATFORM),CHIBIOS)
+        $(call CATASTROPHIC_ERROR,Invalid MATRIX_IDLE_SLEEP_ENABLE,MATRIX_IDLE_SLEEP_ENABLE is only supported on ChibiOS)
+    endif
+    OPT_DEFS += -DMATRIX_IDLE_SLEEP_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/idle_sleep.c
+    SRC += $(PLATFORM_COMMON_DIR)/idle_sleep.c
+endif
+
 ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     SRC += $(PLATFORM_COMMON_DIR)/sleep_led.c
     OPT_DEFS += -DSLEEP_LED_ENABLE
@@ -644,7 +681,16 @@ ifeq ($(strip $(DYNAMIC_KEYMAP_ENABLE)), yes)
     SEND_STRING_ENABLE := yes
 endif
 
-VALID_CUSTOM_MATRIX_TYPES:= yes lite no
+ifeq ($(strip $(ANALOG_MATRIX_ENABLE)), yes)
+    # The analog matrix implements the 'lite' custom matrix functions
+    CUSTOM_MATRIX := lite
+    OPT_DEFS += -DANALOG_MATRIX_ENABLE
+    ANALOG_DRIVER_REQUIRED = yes
+    COMMON_VPATH += $(QUANTUM_DIR)/analog_matrix
+    QUANTUM_SRC += $(QUANTUM_DIR)/analog_matrix/analog_matrix.c
+endif
+
+VALID_CUSTOM_MATRIX_TYPES:= yes lite vendor no
 
 CUSTOM_MATRIX ?= no
 ifneq ($(strip $(CUSTOM_MATRIX)), yes)
@@ -656,7 +702,10 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     QUANTUM_SRC += $(QUANTUM_DIR)/matrix_common.c
 
     # if 'lite' then skip the actual matrix implementation
-    ifneq ($(strip $(CUSTOM_MATRIX)), lite)
+    ifeq ($(strip $(CUSTOM_MATRIX)), vendor)
+        # 'lite' implementation provided by the platform
+        QUANTUM_SRC += matrix_vendor.c
+    else ifneq ($(strip $(CUSTOM_MATRIX)), lite)
         # Include the standard or split matrix code if needed
         QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
     endif
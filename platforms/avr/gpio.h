@@ -38,3 +38,10 @@ typedef uint8_t pin_t;
 #define gpio_read_pin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin)&0xF)))
 
 #define gpio_toggle_pin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
+
+/* Operation of GPIO by port. */
+
+#define gpio_pin_port(pin) ((pin) >> PORT_SHIFTER)
+#define gpio_pin_pad(pin) ((pin)&0xF)
+
+#define gpio_read_port(pin) (PINx_ADDRESS(pin))
@@ -0,0 +1,65 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include <hal.h>
+
+#include "idle_sleep.h"
+
+#if !defined(PAL_USE_CALLBACKS) || (PAL_USE_CALLBACKS != TRUE)
+#    error Idle sleep requires PAL_USE_CALLBACKS to be enabled in halconf.h
+#endif
+
+static BSEMAPHORE_DECL(idle_wakeup_sem, true);
+
+// Edge events are routed per pad number (one EXTI line per pad on STM32), so pins sharing a pad number on
+// different ports cannot all be armed. Only the first one is, and the rest are covered by polling instead.
+static uint32_t armed_pads = 0;
+static pin_t    pad_owner[PAL_IOPORTS_WIDTH];
+static bool     idle_polling = false;
+
+static void idle_sleep_pin_cb(void *arg) {
+    chSysLockFromISR();
+    chBSemSignalI(&idle_wakeup_sem);
+    chSysUnlockFromISR();
+}
+
+void platform_idle_sleep_pin_arm(pin_t pin) {
+    uint32_t pad = PAL_PAD(pin);
+    if (armed_pads & (1UL << pad)) {
+        idle_polling = true;
+        return;
+    }
+    armed_pads |= 1UL << pad;
+    pad_owner[pad] = pin;
+    palEnableLineEvent(pin, PAL_EVENT_MODE_BOTH_EDGES);
+    palSetLineCallback(pin, idle_sleep_pin_cb, NULL);
+}
+
+void platform_idle_sleep_pin_disarm(pin_t pin) {
+    uint32_t pad = PAL_PAD(pin);
+    // Leave the event alone if it belongs to another pin with the same pad number
+    if (!(armed_pads & (1UL << pad)) || pad_owner[pad] != pin) {
+        return;
+    }
+    armed_pads &= ~(1UL << pad);
+    palDisableLineEvent(pin);
+}
+
+void platform_idle_sleep_prepare(void) {
+    chBSemReset(&idle_wakeup_sem, true);
+    idle_polling = false;
+}
+
+void platform_idle_sleep(uint32_t timeout_ms) {
+    if (idle_polling && timeout_ms > MATRIX_IDLE_SLEEP_POLL_PERIOD) {
+        // Some inputs could not be armed, come back soon enough to scan them
+        timeout_ms = MATRIX_IDLE_SLEEP_POLL_PERIOD;
+    }
+    // Blocking here lets the idle thread put the core to sleep until an interrupt signals us
+    chBSemWaitTimeout(&idle_wakeup_sem, TIME_MS2I(timeout_ms));
+}
+
+void platform_idle_sleep_wakeup_i(void) {
+    chBSemSignalI(&idle_wakeup_sem);
+}
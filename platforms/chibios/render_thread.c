@@ -0,0 +1,75 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include <hal.h>
+
+#include "render_thread.h"
+
+// Drivers used by both threads serialise bus access through the ChibiOS bus mutexes
+#if HAL_USE_I2C == TRUE && I2C_USE_MUTUAL_EXCLUSION != TRUE
+#    error RENDER_THREAD_ENABLE requires I2C_USE_MUTUAL_EXCLUSION to be enabled in halconf.h
+#endif
+#if HAL_USE_SPI == TRUE && SPI_USE_MUTUAL_EXCLUSION != TRUE
+#    error RENDER_THREAD_ENABLE requires SPI_USE_MUTUAL_EXCLUSION to be enabled in halconf.h
+#endif
+
+#ifdef MAIN_LOOP_RATE_HZ
+// Rates above the system tick frequency would round down to a zero length period
+#    define MAIN_LOOP_PERIOD (TIME_US2I(1000000 / MAIN_LOOP_RATE_HZ) > 0 ? TIME_US2I(1000000 / MAIN_LOOP_RATE_HZ) : (sysinterval_t)1)
+
+static systime_t main_loop_deadline;
+#endif
+
+static THD_WORKING_AREA(waRenderThread, RENDER_THREAD_STACK_SIZE);
+static MUTEX_DECL(render_mutex);
+
+static THD_FUNCTION(RenderThread, arg) {
+    (void)arg;
+    chRegSetThreadName("render");
+    while (true) {
+        render_thread_task();
+        chThdSleepMilliseconds(RENDER_THREAD_INTERVAL_MS);
+    }
+}
+
+void render_thread_lock(void) {
+    chMtxLock(&render_mutex);
+}
+
+void render_thread_unlock(void) {
+    chMtxUnlock(&render_mutex);
+}
+
+void render_thread_init(void) {
+    // The main thread owns the keyboard state except while it waits in render_thread_main_loop_wait()
+    render_thread_lock();
+    render_thread_publish();
+#ifdef MAIN_LOOP_RATE_HZ
+    // The main loop is latency critical, rendering only gets what the main loop leaves over
+    chThdSetPriority(HIGHPRIO - 1);
+    chThdCreateStatic(waRenderThread, sizeof(waRenderThread), LOWPRIO, RenderThread, NULL);
+    main_loop_deadline = chVTGetSystemTimeX();
+#else
+    // Same priority as the main loop, the render thread runs whenever the main loop yields
+    chThdCreateStatic(waRenderThread, sizeof(waRenderThread), chThdGetPriorityX(), RenderThread, NULL);
+#endif
+}
+
+void render_thread_main_loop_wait(void) {
+    render_thread_unlock();
+#ifdef MAIN_LOOP_RATE_HZ
+    systime_t previous = main_loop_deadline;
+    systime_t now      = chVTGetSystemTimeX();
+    main_loop_deadline = chTimeAddX(main_loop_deadline, MAIN_LOOP_PERIOD);
+    if (chTimeIsInRangeX(now, previous, main_loop_deadline)) {
+        chThdSleepUntil(main_loop_deadline);
+    } else {
+        // The iteration overran its window, resynchronise rather than trying to catch up
+        main_loop_deadline = now;
+    }
+#else
+    chThdYield();
+#endif
+    render_thread_lock();
+}
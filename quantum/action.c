@@ -284,6 +284,9 @@ void process_record(keyrecord_t *record) {
 #ifdef FLOW_TAP_TERM
     flow_tap_update_last_event(record);
 #endif // FLOW_TAP_TERM
+#if defined(SPECULATIVE_HOLD) && !defined(NO_ACTION_TAPPING)
+    speculative_hold_settled(record);
+#endif // SPECULATIVE_HOLD
 
     if (!process_record_quantum(record)) {
 #ifndef NO_ACTION_ONESHOT
@@ -291,11 +294,13 @@ void process_record(keyrecord_t *record) {
             clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
         }
 #endif
+        release_source_layers_cache(record);
         return;
     }
 
     process_record_handler(record);
     post_process_record_quantum(record);
+    release_source_layers_cache(record);
 }
 
 void process_record_handler(keyrecord_t *record) {
@@ -2,11 +2,25 @@
 #include <stdint.h>
 
 #include "keyboard.h"
+#include "matrix.h"
 #include "action.h"
+#include "debug.h"
 #include "encoder.h"
+#include "keymap_common.h"
 #include "util.h"
 #include "action_layer.h"
 
+/* Layers with a keymap, below MAX_LAYER. Also correct when MAX_LAYER fills layer_state_t. */
+#define LAYER_STATE_MASK ((layer_state_t)(((layer_state_t)2 << (MAX_LAYER - 1)) - 1))
+
+#ifdef LAYER_STATE_64BIT
+#    define LAYER_STATE_FMT "%08lX%08lX"
+#    define LAYER_STATE_FMT_ARGS(state) (unsigned long)((state) >> 32), (unsigned long)((state) & 0xFFFFFFFF)
+#else
+#    define LAYER_STATE_FMT "%08hX"
+#    define LAYER_STATE_FMT_ARGS(state) (state)
+#endif
+
 /** \brief Default Layer State
  */
 layer_state_t default_layer_state = 0;
@@ -57,10 +71,10 @@ static void default_layer_state_set(layer_state_t state) {
 
 /** \brief Default Layer Print
  *
- * Print out the hex value of the 32-bit default layer state, as well as the value of the highest bit.
+ * Print out the hex value of the default layer state, as well as the value of the highest bit.
  */
 void default_layer_debug(void) {
-    ac_dprintf("%08hX(%u)", default_layer_state, get_highest_layer(default_layer_state));
+    ac_dprintf(LAYER_STATE_FMT "(%u)", LAYER_STATE_FMT_ARGS(default_layer_state), get_highest_layer(default_layer_state));
 }
 
 /** \brief Default Layer Set
@@ -228,10 +242,10 @@ void layer_xor(layer_state_t state) {
 
 /** \brief Layer debug printing
  *
- * Print out the hex value of the 32-bit layer state, as well as the value of the highest bit.
+ * Print out the hex value of the layer state, as well as the value of the highest bit.
  */
 void layer_debug(void) {
-    ac_dprintf("%08hX(%u)", layer_state, get_highest_layer(layer_state));
+    ac_dprintf(LAYER_STATE_FMT "(%u)", LAYER_STATE_FMT_ARGS(layer_state), get_highest_layer(layer_state));
 }
 #endif
 
@@ -272,11 +286,8 @@ uint8_t read_source_layers_cache_impl(uint16_t entry_number, uint8_t cache[][MAX
     return layer;
 }
 
-/** \brief update encoder source layers cache
- *
- * Updates the cached encoders when changing layers
- */
-void update_source_layers_cache(keypos_t key, uint8_t layer) {
+/* stores the layer of key in the bit planes */
+static void source_layers_planes_update(keypos_t key, uint8_t layer) {
     if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
         const uint16_t entry_number = (uint16_t)(key.row * MATRIX_COLS) + key.col;
         update_source_layers_cache_impl(layer, entry_number, source_layers_cache);
@@ -289,11 +300,8 @@ void update_source_layers_cache(keypos_t key, uint8_t layer) {
 #    endif // ENCODER_MAP_ENABLE
 }
 
-/** \brief read source layers cache
- *
- * reads the cached keys stored when the layer was changed
- */
-uint8_t read_source_layers_cache(keypos_t key) {
+/* reads the layer of key from the bit planes */
+static uint8_t source_layers_planes_read(keypos_t key) {
     if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
         const uint16_t entry_number = (uint16_t)(key.row * MATRIX_COLS) + key.col;
         return read_source_layers_cache_impl(entry_number, source_layers_cache);
@@ -306,6 +314,249 @@ uint8_t read_source_layers_cache(keypos_t key) {
 #    endif // ENCODER_MAP_ENABLE
     return 0;
 }
+
+#    ifndef SOURCE_LAYERS_CACHE_TABLE
+/** \brief update encoder source layers cache
+ *
+ * Updates the cached encoders when changing layers
+ */
+void update_source_layers_cache(keypos_t key, uint8_t layer) {
+    source_layers_planes_update(key, layer);
+}
+
+/** \brief read source layers cache
+ *
+ * reads the cached keys stored when the layer was changed
+ */
+uint8_t read_source_layers_cache(keypos_t key) {
+    return source_layers_planes_read(key);
+}
+#    else // SOURCE_LAYERS_CACHE_TABLE
+/** \brief source layers table
+ *
+ * The layer and action of each key recently pressed, in an open addressed
+ * table with linear probing, so that a release is usually found with a single
+ * probe and reuses the action resolved on press.
+ *
+ * Entries outlive the release of their key, as the tapping code may process
+ * it again later, and are only replaced by the next press of the same key or
+ * evicted, once their release has been processed, when the table runs out of
+ * space. A press which finds the table full of held keys is recorded in the
+ * bit planes above instead.
+ */
+#        ifndef SOURCE_LAYERS_CACHE_TABLE_SIZE
+#            define SOURCE_LAYERS_CACHE_TABLE_SIZE 16
+#        endif
+#        if SOURCE_LAYERS_CACHE_TABLE_SIZE < 2 || SOURCE_LAYERS_CACHE_TABLE_SIZE > 128 || (SOURCE_LAYERS_CACHE_TABLE_SIZE & (SOURCE_LAYERS_CACHE_TABLE_SIZE - 1)) != 0
+#            error "SOURCE_LAYERS_CACHE_TABLE_SIZE must be a power of two between 2 and 128"
+#        endif
+#        define SOURCE_LAYERS_CACHE_MASK (SOURCE_LAYERS_CACHE_TABLE_SIZE - 1)
+#        define SOURCE_LAYERS_CACHE_HOME(k) ((uint8_t)((k).row * MATRIX_COLS + (k).col) & SOURCE_LAYERS_CACHE_MASK)
+
+typedef struct source_layers_entry_t {
+    action_t action;
+    keypos_t key;
+    uint8_t  layer;
+    bool     used : 1;
+    bool     released : 1;
+} source_layers_entry_t;
+
+static source_layers_entry_t source_layers_table[SOURCE_LAYERS_CACHE_TABLE_SIZE] = {0};
+
+/* whether the bit planes would have cached this key */
+static bool source_layers_cache_holds(keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return true;
+    }
+#        ifdef ENCODER_MAP_ENABLE
+    if (key.row == KEYLOC_ENCODER_CW || key.row == KEYLOC_ENCODER_CCW) {
+        return true;
+    }
+#        endif // ENCODER_MAP_ENABLE
+    return false;
+}
+
+/* index of the entry of key, else of the free slot ending its probe sequence, else the table size when full */
+static uint8_t source_layers_cache_probe(keypos_t key) {
+    uint8_t i = SOURCE_LAYERS_CACHE_HOME(key);
+    for (uint8_t n = 0; n < SOURCE_LAYERS_CACHE_TABLE_SIZE; n++, i = (i + 1) & SOURCE_LAYERS_CACHE_MASK) {
+        if (!source_layers_table[i].used || KEYEQ(source_layers_table[i].key, key)) {
+            return i;
+        }
+    }
+    return SOURCE_LAYERS_CACHE_TABLE_SIZE;
+}
+
+/* frees slot i, moving back later entries so that no probe sequence has a hole */
+static void source_layers_cache_remove(uint8_t i) {
+    source_layers_table[i].used = false;
+    for (uint8_t j = (i + 1) & SOURCE_LAYERS_CACHE_MASK; source_layers_table[j].used; j = (j + 1) & SOURCE_LAYERS_CACHE_MASK) {
+        const uint8_t home = SOURCE_LAYERS_CACHE_HOME(source_layers_table[j].key);
+        /* entries whose home slot lies in (i, j] are still reachable */
+        if (((home - i - 1) & SOURCE_LAYERS_CACHE_MASK) < ((j - i) & SOURCE_LAYERS_CACHE_MASK)) {
+            continue;
+        }
+        source_layers_table[i]      = source_layers_table[j];
+        source_layers_table[j].used = false;
+        i                           = j;
+    }
+}
+
+/* drops the entries of keys whose release has been processed */
+static void source_layers_cache_evict(void) {
+    for (uint8_t i = 0; i < SOURCE_LAYERS_CACHE_TABLE_SIZE;) {
+        if (source_layers_table[i].used && source_layers_table[i].released) {
+            /* another entry may have moved into slot i */
+            source_layers_cache_remove(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+static const source_layers_entry_t *source_layers_cache_find(keypos_t key) {
+    const uint8_t i = source_layers_cache_probe(key);
+    if (i < SOURCE_LAYERS_CACHE_TABLE_SIZE && source_layers_table[i].used) {
+        return &source_layers_table[i];
+    }
+    return NULL;
+}
+
+static const source_layers_entry_t *source_layers_cache_store(keypos_t key, uint8_t layer) {
+    if (!source_layers_cache_holds(key)) {
+        return NULL;
+    }
+
+    uint8_t i = source_layers_cache_probe(key);
+    if (i == SOURCE_LAYERS_CACHE_TABLE_SIZE) {
+        source_layers_cache_evict();
+        i = source_layers_cache_probe(key);
+    }
+    if (i == SOURCE_LAYERS_CACHE_TABLE_SIZE) {
+        /* every entry belongs to a key whose release is still to come, none may be lost */
+        dprintf("source layers cache: full, using the bit planes\n");
+        source_layers_planes_update(key, layer);
+        return NULL;
+    }
+
+    source_layers_entry_t *entry = &source_layers_table[i];
+    entry->key                   = key;
+    entry->layer                 = layer;
+    entry->action                = action_for_key(layer, key);
+    entry->used                  = true;
+    entry->released              = false;
+    return entry;
+}
+
+/** \brief update source layers cache
+ *
+ * Records the layer, and the action on it, of a key being pressed
+ */
+void update_source_layers_cache(keypos_t key, uint8_t layer) {
+    source_layers_cache_store(key, layer);
+}
+
+/** \brief read source layers cache
+ *
+ * Gets the layer a held key was pressed on
+ */
+uint8_t read_source_layers_cache(keypos_t key) {
+    const source_layers_entry_t *entry = source_layers_cache_find(key);
+    return entry ? entry->layer : source_layers_planes_read(key);
+}
+
+/** \brief release source layers cache
+ *
+ * Marks a key as released once its release has been processed, making its
+ * entry the first to be evicted. The entry stays readable until then.
+ */
+void release_source_layers_cache(keyrecord_t *record) {
+    if (record->event.pressed) {
+        return;
+    }
+    const uint8_t i = source_layers_cache_probe(record->event.key);
+    if (i < SOURCE_LAYERS_CACHE_TABLE_SIZE && source_layers_table[i].used) {
+        source_layers_table[i].released = true;
+    }
+}
+#    endif // SOURCE_LAYERS_CACHE_TABLE
+#endif
+
+#if defined(LAYER_KEYCODE_CACHE) && !defined(NO_ACTION_LAYER)
+/** \brief layer keycode cache
+ *
+ * The effective keycode of each matrix position, along with the layer it was
+ * resolved from. Entries are resolved on demand, and when the active layers
+ * change only those entries which could resolve differently are dropped:
+ * a newly enabled layer above the cached one, or the cached layer itself
+ * being disabled. That sweep visits every cached key once per layer change,
+ * which is paid on the first lookup afterwards rather than on each event.
+ */
+typedef struct layer_keycode_cache_entry_t {
+    uint16_t keycode;
+    uint8_t  layer;
+} layer_keycode_cache_entry_t;
+
+static layer_keycode_cache_entry_t layer_keycode_cache[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t                layer_keycode_cache_valid[MATRIX_ROWS];
+static layer_state_t               layer_keycode_cache_layers = 0;
+
+void layer_keycode_cache_invalidate(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        layer_keycode_cache_valid[row] = 0;
+    }
+}
+
+static void layer_keycode_cache_sync(void) {
+    layer_state_t layers = layer_state | default_layer_state;
+    if (layers == layer_keycode_cache_layers) {
+        return;
+    }
+
+    layer_state_t raised       = layers & ~layer_keycode_cache_layers;
+    layer_state_t lowered      = layer_keycode_cache_layers & ~layers;
+    layer_keycode_cache_layers = layers;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t valid = layer_keycode_cache_valid[row];
+        for (uint8_t col = 0; valid; col++, valid >>= 1) {
+            if (!(valid & 1)) {
+                continue;
+            }
+            uint8_t layer = layer_keycode_cache[row][col].layer;
+            if (((raised >> layer) >> 1) || ((lowered >> layer) & 1)) {
+                layer_keycode_cache_valid[row] &= ~(MATRIX_ROW_SHIFTER << col);
+            }
+        }
+    }
+}
+
+static const layer_keycode_cache_entry_t *layer_keycode_cache_get(keypos_t key) {
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return NULL;
+    }
+
+    layer_keycode_cache_sync();
+
+    layer_keycode_cache_entry_t *entry = &layer_keycode_cache[key.row][key.col];
+    if (!(layer_keycode_cache_valid[key.row] & (MATRIX_ROW_SHIFTER << key.col))) {
+        /* same walk as layer_switch_get_layer(), falling back to layer 0 */
+        entry->layer   = 0;
+        entry->keycode = keymap_key_to_keycode(0, key);
+        for (layer_state_t layers = layer_keycode_cache_layers & LAYER_STATE_MASK; layers;) {
+            uint8_t  i       = get_highest_layer(layers);
+            uint16_t keycode = keymap_key_to_keycode(i, key);
+            if (action_for_keycode(keycode).code != ACTION_TRANSPARENT) {
+                entry->layer   = i;
+                entry->keycode = keycode;
+                break;
+            }
+            layers &= ~((layer_state_t)1 << i);
+        }
+        layer_keycode_cache_valid[key.row] |= MATRIX_ROW_SHIFTER << key.col;
+    }
+    return entry;
+}
 #endif
 
 /** \brief Store or get action (FIXME: Needs better summary)
@@ -325,9 +576,30 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 
     if (pressed) {
         layer = layer_switch_get_layer(key);
+#    ifdef SOURCE_LAYERS_CACHE_TABLE
+        const source_layers_entry_t *held = source_layers_cache_store(key, layer);
+        if (held) {
+            return held->action;
+        }
+#    else
         update_source_layers_cache(key, layer);
+#    endif
     } else {
+#    ifdef SOURCE_LAYERS_CACHE_TABLE
+        /* the action snapshot taken on press, without reading the keymap */
+        const source_layers_entry_t *held = source_layers_cache_find(key);
+        if (held) {
+            return held->action;
+        }
+#    endif
         layer = read_source_layers_cache(key);
+#    ifdef LAYER_KEYCODE_CACHE
+        /* the layer recorded on press usually still resolves the same way, saving a keymap read */
+        const layer_keycode_cache_entry_t *entry = layer_keycode_cache_get(key);
+        if (entry && entry->layer == layer) {
+            return action_for_keycode(entry->keycode);
+        }
+#    endif
     }
     return action_for_key(layer, key);
 #else
@@ -341,18 +613,24 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
  */
 uint8_t layer_switch_get_layer(keypos_t key) {
 #ifndef NO_ACTION_LAYER
+#    ifdef LAYER_KEYCODE_CACHE
+    const layer_keycode_cache_entry_t *entry = layer_keycode_cache_get(key);
+    if (entry) {
+        return entry->layer;
+    }
+#    endif
+
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
-    /* check top layer first */
-    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
-        if (layers & ((layer_state_t)1 << i)) {
-            action = action_for_key(i, key);
-            if (action.code != ACTION_TRANSPARENT) {
-                return i;
-            }
+    /* check top layer first, visiting only the active ones */
+    for (layer_state_t layers = (layer_state | default_layer_state) & LAYER_STATE_MASK; layers;) {
+        uint8_t i = get_highest_layer(layers);
+        action    = action_for_key(i, key);
+        if (action.code != ACTION_TRANSPARENT) {
+            return i;
         }
+        layers &= ~((layer_state_t)1 << i);
     }
     /* fall back to layer 0 */
     return 0;
@@ -366,6 +644,12 @@ uint8_t layer_switch_get_layer(keypos_t key) {
  * Gets action code based on key position
  */
 action_t layer_switch_get_action(keypos_t key) {
+#if defined(LAYER_KEYCODE_CACHE) && !defined(NO_ACTION_LAYER)
+    const layer_keycode_cache_entry_t *entry = layer_keycode_cache_get(key);
+    if (entry) {
+        return action_for_keycode(entry->keycode);
+    }
+#endif
     return action_for_key(layer_switch_get_layer(key), key);
 }
 
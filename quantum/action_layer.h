@@ -35,14 +35,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        ifndef LAYER_STATE_16BIT
 #            define LAYER_STATE_16BIT
 #        endif
-#    else
+#    elif DYNAMIC_KEYMAP_LAYER_COUNT <= 32
 #        ifndef LAYER_STATE_32BIT
 #            define LAYER_STATE_32BIT
 #        endif
+#    else
+#        ifndef LAYER_STATE_64BIT
+#            define LAYER_STATE_64BIT
+#        endif
 #    endif
 #endif
 
-#if !defined(LAYER_STATE_8BIT) && !defined(LAYER_STATE_16BIT) && !defined(LAYER_STATE_32BIT)
+#if !defined(LAYER_STATE_8BIT) && !defined(LAYER_STATE_16BIT) && !defined(LAYER_STATE_32BIT) && !defined(LAYER_STATE_64BIT)
 #    define LAYER_STATE_16BIT
 #endif
 
@@ -67,6 +71,13 @@ typedef uint32_t layer_state_t;
 #        define MAX_LAYER 32
 #    endif
 #    define get_highest_layer(state) biton32(state)
+#elif defined(LAYER_STATE_64BIT)
+typedef uint64_t layer_state_t;
+#    define MAX_LAYER_BITS 6
+#    ifndef MAX_LAYER
+#        define MAX_LAYER 64
+#    endif
+#    define get_highest_layer(state) biton64(state)
 #else
 #    error Layer Mask size not specified.  HOW?!
 #endif
@@ -164,10 +175,23 @@ layer_state_t update_tri_layer_state(layer_state_t state, uint8_t layer1, uint8_
 void    update_source_layers_cache(keypos_t key, uint8_t layer);
 uint8_t read_source_layers_cache(keypos_t key);
 #endif
+#if defined(SOURCE_LAYERS_CACHE_TABLE) && !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
+/* mark the cached layer of a key as evictable once its release has been processed */
+void release_source_layers_cache(keyrecord_t *record);
+#else
+#    define release_source_layers_cache(record)
+#endif
 action_t store_or_get_action(bool pressed, keypos_t key);
 
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+#if defined(LAYER_KEYCODE_CACHE) && !defined(NO_ACTION_LAYER)
+/* discard all cached layer resolutions, must be called whenever keymap contents change at runtime */
+void layer_keycode_cache_invalidate(void);
+#else
+#    define layer_keycode_cache_invalidate()
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
@@ -1,11 +1,14 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "action_util.h"
+#include "debug.h"
 #include "keycode.h"
+#include "keycode_config.h"
 #include "quantum_keycodes.h"
 #include "timer.h"
 
@@ -51,7 +54,7 @@ __attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *re
 }
 #    endif
 
-#    if defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM)
+#    if defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM) || defined(PREDICTIVE_TAP_HOLD)
 #        define REGISTERED_TAPS_SIZE 8
 // Array of tap-hold keys that have been settled as tapped but not yet released.
 static keypos_t registered_taps[REGISTERED_TAPS_SIZE] = {};
@@ -69,7 +72,7 @@ static void debug_registered_taps(void);
 static bool is_mt_or_lt(uint16_t keycode) {
     return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
 }
-#    endif // defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM)
+#    endif // defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM) || defined(PREDICTIVE_TAP_HOLD)
 
 #    if defined(CHORDAL_HOLD)
 extern const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM;
@@ -110,10 +113,65 @@ static bool     flow_tap_expired      = true;
 static bool flow_tap_key_if_within_term(keyrecord_t *record, uint16_t prev_time);
 #    endif // defined(FLOW_TAP_TERM)
 
+#    if defined(PREDICTIVE_TAP_HOLD)
+typedef enum {
+    PREDICTIVE_NONE,
+    PREDICTIVE_TAP,        // settled as tapped by the regular rules
+    PREDICTIVE_HOLD,       // settled as held by the regular rules
+    PREDICTIVE_EARLY_HOLD, // settled as held before the tapping term
+    PREDICTIVE_EARLY_TAP,  // settled as tapped on the press of another key
+} predictive_outcome_t;
+
+static predictive_tap_hold_stats_t predictive_stats[PREDICTIVE_TAP_HOLD_KEYS] = {};
+static uint8_t                     predictive_stats_count                     = 0;
+
+// The last tap-hold key settled by the engine, until its outcome is confirmed
+static struct {
+    keypos_t key;
+    uint16_t time;
+    uint16_t tapping_term;
+    uint16_t gap;
+    uint8_t  outcome;
+} predictive_pending = {};
+
+// The tapping term of the tapping key, computed on the first check after a key becomes the tapping key rather than on
+// every event, including ticks
+static struct {
+    keypos_t key;
+    uint16_t time;
+    uint8_t  count;
+    bool     valid;
+    uint16_t term;
+} predictive_term = {};
+
+/** Returns the tapping term of the unsettled tapping key, shortened when its taps are consistently shorter. */
+static uint16_t predictive_tapping_term(void);
+/** Returns whether the press of `other` is early enough to settle the tapping key as tapped. */
+static bool predictive_tap_hold_predicts_tap(uint16_t tapping_keycode, keyrecord_t *other);
+/** Records the outcome of the tapping key, to be confirmed by the next events. */
+static void predictive_tap_hold_settled(predictive_outcome_t outcome, uint16_t time);
+/** Collects timing samples from every key event. */
+static void predictive_tap_hold_track(keyrecord_t *record);
+
+#        define WITHIN_PREDICTED_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < predictive_tapping_term())
+#    else
+#        define WITHIN_PREDICTED_TAPPING_TERM(e) WITHIN_TAPPING_TERM(e)
+#    endif // defined(PREDICTIVE_TAP_HOLD)
+
+#    define WAITING_BUFFER_NEXT(i) (((i) + 1) & (WAITING_BUFFER_SIZE - 1))
+#    define WAITING_BUFFER_COUNT() ((uint8_t)(waiting_buffer_head - waiting_buffer_tail) & (WAITING_BUFFER_SIZE - 1))
+// Hashes a key position to one bit of a waiting buffer key filter.
+#    define WAITING_BUFFER_KEY_BIT(k) ((uint32_t)1 << (((k).row * 11 + (k).col) & 31))
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
+// Keys with buffered release ([0]) and press ([1]) events. Bits are only
+// cleared once the buffer drains, so a set bit means the key may be buffered
+// and a clear bit that it is not, which saves scanning for most lookups.
+static uint32_t               waiting_buffer_keys[2] = {};
+static waiting_buffer_stats_t waiting_buffer_stats   = {};
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
@@ -124,11 +182,29 @@ static void waiting_buffer_scan_tap(void);
 static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
+#    if defined(SPECULATIVE_HOLD)
+#        define SPECULATIVE_KEYS_SIZE 8
+// Mod-tap keys pressed but not yet settled, and the mods sent for each.
+static struct {
+    keypos_t key;
+    uint8_t  mods;
+} speculative_keys[SPECULATIVE_KEYS_SIZE] = {};
+static uint8_t num_speculative_keys       = 0;
+
+/** Sends the mods of a newly pressed mod-tap key ahead of the tap-hold decision. */
+static void speculative_hold_press(keyrecord_t *record);
+#    endif // defined(SPECULATIVE_HOLD)
+
 /** \brief Action Tapping Process
  *
  * FIXME: Needs doc
  */
 void action_tapping_process(keyrecord_t record) {
+#    if defined(SPECULATIVE_HOLD)
+    if (IS_KEYEVENT(record.event) && record.event.pressed) {
+        speculative_hold_press(&record);
+    }
+#    endif // defined(SPECULATIVE_HOLD)
     if (process_tapping(&record)) {
         if (IS_EVENT(record.event)) {
             ac_dprintf("processed: ");
@@ -138,10 +214,13 @@ void action_tapping_process(keyrecord_t record) {
     } else {
         if (!waiting_buffer_enq(record)) {
             // clear all in case of overflow.
-            ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
+            dprintf("waiting_buffer: overflow %u, clearing all states\n", waiting_buffer_stats.overflows);
             clear_keyboard();
             waiting_buffer_clear();
             tapping_key = (keyrecord_t){0};
+#    if defined(SPECULATIVE_HOLD)
+            num_speculative_keys = 0;
+#    endif // defined(SPECULATIVE_HOLD)
         }
     }
 
@@ -149,7 +228,7 @@ void action_tapping_process(keyrecord_t record) {
     if (IS_EVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         ac_dprintf("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
             debug_record(waiting_buffer[waiting_buffer_tail]);
@@ -223,7 +302,7 @@ void action_tapping_process(keyrecord_t record) {
 bool process_tapping(keyrecord_t *keyp) {
     const keyevent_t event = keyp->event;
 
-#    if defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM)
+#    if defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM) || defined(PREDICTIVE_TAP_HOLD)
     if (!event.pressed) {
         const int8_t i = registered_tap_find(event.key);
         if (i != -1) {
@@ -235,7 +314,11 @@ bool process_tapping(keyrecord_t *keyp) {
             debug_registered_taps();
         }
     }
-#    endif // defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM)
+#    endif // defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM) || defined(PREDICTIVE_TAP_HOLD)
+
+#    if defined(PREDICTIVE_TAP_HOLD)
+    predictive_tap_hold_track(keyp);
+#    endif // defined(PREDICTIVE_TAP_HOLD)
 
     // state machine is in the "reset" state, no tapping key is to be
     // processed
@@ -266,13 +349,13 @@ bool process_tapping(keyrecord_t *keyp) {
         return true;
     }
 
-#    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(CHORDAL_HOLD) || defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
+#    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(CHORDAL_HOLD) || defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY) || defined(PREDICTIVE_TAP_HOLD)
     TAP_DEFINE_KEYCODE;
 #    endif
 
     // process "pressed" tapping key state
     if (tapping_key.event.pressed) {
-        if (WITHIN_TAPPING_TERM(event) || MAYBE_RETRO_SHIFTING(event, keyp)) {
+        if (WITHIN_PREDICTED_TAPPING_TERM(event) || MAYBE_RETRO_SHIFTING(event, keyp)) {
             if (IS_NOEVENT(event)) {
                 // early return for tick events
                 return true;
@@ -283,6 +366,9 @@ bool process_tapping(keyrecord_t *keyp) {
                     // first tap!
                     ac_dprintf("Tapping: First tap(0->1).\n");
                     tapping_key.tap.count = 1;
+#    if defined(PREDICTIVE_TAP_HOLD)
+                    predictive_tap_hold_settled(PREDICTIVE_TAP, event.time);
+#    endif // defined(PREDICTIVE_TAP_HOLD)
                     debug_tapping_key();
                     process_record(&tapping_key);
 
@@ -293,7 +379,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     // Now that tapping_key has settled as tapped, check whether
                     // Flow Tap applies to following yet-unsettled keys.
                     uint16_t prev_time = tapping_key.event.time;
-                    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+                    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
                         keyrecord_t *record = &waiting_buffer[waiting_buffer_tail];
                         if (!record->event.pressed) {
                             break;
@@ -347,13 +433,16 @@ bool process_tapping(keyrecord_t *keyp) {
                 ) {
                     // clang-format on
                     ac_dprintf("Tapping: End. No tap. Interfered by typing key\n");
+#    if defined(PREDICTIVE_TAP_HOLD)
+                    predictive_tap_hold_settled(PREDICTIVE_HOLD, event.time);
+#    endif // defined(PREDICTIVE_TAP_HOLD)
                     process_record(&tapping_key);
 
 #    if defined(CHORDAL_HOLD)
                     uint8_t first_tap = waiting_buffer_find_chordal_hold_tap();
                     ac_dprintf("first_tap = %u\n", first_tap);
                     if (first_tap < WAITING_BUFFER_SIZE) {
-                        for (; waiting_buffer_tail != first_tap; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+                        for (; waiting_buffer_tail != first_tap; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
                             ac_dprintf("Processing [%u]\n", waiting_buffer_tail);
                             process_record(&waiting_buffer[waiting_buffer_tail]);
                         }
@@ -420,6 +509,20 @@ bool process_tapping(keyrecord_t *keyp) {
                     if (event.pressed) {
                         tapping_key.tap.interrupted = true;
 
+#    if defined(PREDICTIVE_TAP_HOLD)
+                        if (is_mt_or_lt(tapping_keycode) && !is_tap_record(keyp) && predictive_tap_hold_predicts_tap(tapping_keycode, keyp)) {
+                            // Pressed sooner than this key has ever been used
+                            // in a chord, settle it as tapped right away.
+                            ac_dprintf("Tapping: End. Predicted tap\n");
+                            tapping_key.tap.interrupted = false;
+                            tapping_key.tap.count       = 1;
+                            predictive_tap_hold_settled(PREDICTIVE_EARLY_TAP, event.time);
+                            registered_taps_add(tapping_key.event.key);
+                            debug_registered_taps();
+                            process_record(&tapping_key);
+                            tapping_key = (keyrecord_t){0};
+                        } else
+#    endif // PREDICTIVE_TAP_HOLD
 #    if defined(CHORDAL_HOLD)
                         if (is_mt_or_lt(tapping_keycode) && !get_chordal_hold(tapping_keycode, &tapping_key, get_record_keycode(keyp, false), keyp)) {
                             // In process_action(), HOLD_ON_OTHER_KEY_PRESS
@@ -447,13 +550,16 @@ bool process_tapping(keyrecord_t *keyp) {
                             // Settle the tapping key as *held*, since
                             // HOLD_ON_OTHER_KEY_PRESS is enabled for this key.
                             ac_dprintf("Tapping: End. No tap. Interfered by pressed key\n");
+#    if defined(PREDICTIVE_TAP_HOLD)
+                            predictive_tap_hold_settled(PREDICTIVE_HOLD, event.time);
+#    endif // defined(PREDICTIVE_TAP_HOLD)
                             process_record(&tapping_key);
 
 #    if defined(CHORDAL_HOLD)
                             if (waiting_buffer_tail != waiting_buffer_head && is_tap_record(&waiting_buffer[waiting_buffer_tail])) {
                                 tapping_key = waiting_buffer[waiting_buffer_tail];
                                 // Pop tail from the queue.
-                                waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+                                waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail);
                                 debug_waiting_buffer();
                             } else
 #    endif // CHORDAL_HOLD
@@ -517,6 +623,9 @@ bool process_tapping(keyrecord_t *keyp) {
                 ac_dprintf("Tapping: End. Timeout. Not tap(0): ");
                 debug_event(event);
                 ac_dprintf("\n");
+#    if defined(PREDICTIVE_TAP_HOLD)
+                predictive_tap_hold_settled(WITHIN_TAPPING_TERM(event) ? PREDICTIVE_EARLY_HOLD : PREDICTIVE_HOLD, event.time);
+#    endif // defined(PREDICTIVE_TAP_HOLD)
                 process_record(&tapping_key);
                 tapping_key = (keyrecord_t){0};
                 debug_tapping_key();
@@ -629,13 +738,23 @@ bool waiting_buffer_enq(keyrecord_t record) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
         ac_dprintf("waiting_buffer_enq: Over flow.\n");
+        if (waiting_buffer_stats.overflows < UINT16_MAX) {
+            ++waiting_buffer_stats.overflows;
+        }
         return false;
     }
 
+    if (waiting_buffer_head == waiting_buffer_tail) {
+        waiting_buffer_keys[0] = waiting_buffer_keys[1] = 0;
+    }
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head                 = WAITING_BUFFER_NEXT(waiting_buffer_head);
+    waiting_buffer_keys[record.event.pressed] |= WAITING_BUFFER_KEY_BIT(record.event.key);
+    if (WAITING_BUFFER_COUNT() > waiting_buffer_stats.high_water) {
+        waiting_buffer_stats.high_water = WAITING_BUFFER_COUNT();
+    }
 
     ac_dprintf("waiting_buffer_enq: ");
     debug_waiting_buffer();
@@ -647,8 +766,25 @@ bool waiting_buffer_enq(keyrecord_t record) {
  * FIXME: Needs docs
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head    = 0;
+    waiting_buffer_tail    = 0;
+    waiting_buffer_keys[0] = waiting_buffer_keys[1] = 0;
+}
+
+/** \brief Whether an event for `key` in the given state may be buffered.
+ *
+ * False means it certainly is not, true that the buffer must be searched.
+ */
+static bool waiting_buffer_may_contain(keypos_t key, bool pressed) {
+    return waiting_buffer_head != waiting_buffer_tail && (waiting_buffer_keys[pressed] & WAITING_BUFFER_KEY_BIT(key));
+}
+
+waiting_buffer_stats_t waiting_buffer_get_stats(void) {
+    return waiting_buffer_stats;
+}
+
+void waiting_buffer_reset_stats(void) {
+    waiting_buffer_stats = (waiting_buffer_stats_t){0};
 }
 
 /** \brief Waiting buffer typed
@@ -656,7 +792,10 @@ void waiting_buffer_clear(void) {
  * FIXME: Needs docs
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    if (!waiting_buffer_may_contain(event.key, !event.pressed)) {
+        return false;
+    }
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -669,7 +808,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (waiting_buffer[i].event.pressed) return true;
     }
     return false;
@@ -683,22 +822,26 @@ void waiting_buffer_scan_tap(void) {
     // early return if:
     // - tapping already is settled
     // - invalid state: tapping_key released && tap.count == 0
-    if ((tapping_key.tap.count > 0) || !tapping_key.event.pressed) {
+    // - the tapping key release is not buffered
+    if ((tapping_key.tap.count > 0) || !tapping_key.event.pressed || !waiting_buffer_may_contain(tapping_key.event.key, false)) {
         return;
     }
 
 #    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
     TAP_DEFINE_KEYCODE;
 #    endif
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         keyrecord_t *candidate = &waiting_buffer[i];
         // clang-format off
         if (IS_EVENT(candidate->event) && KEYEQ(candidate->event.key, tapping_key.event.key) && !candidate->event.pressed && (
-            WITHIN_TAPPING_TERM(waiting_buffer[i].event) || MAYBE_RETRO_SHIFTING(waiting_buffer[i].event, &tapping_key)
+            WITHIN_PREDICTED_TAPPING_TERM(waiting_buffer[i].event) || MAYBE_RETRO_SHIFTING(waiting_buffer[i].event, &tapping_key)
         )) {
             // clang-format on
             tapping_key.tap.count = 1;
             candidate->tap.count  = 1;
+#    if defined(PREDICTIVE_TAP_HOLD)
+            predictive_tap_hold_settled(PREDICTIVE_TAP, candidate->event.time);
+#    endif // defined(PREDICTIVE_TAP_HOLD)
             process_record(&tapping_key);
 
             ac_dprintf("waiting_buffer_scan_tap: found at [%u]\n", i);
@@ -708,7 +851,7 @@ void waiting_buffer_scan_tap(void) {
     }
 }
 
-#    if defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM)
+#    if defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM) || defined(PREDICTIVE_TAP_HOLD)
 static void registered_taps_add(keypos_t key) {
     if (num_registered_taps >= REGISTERED_TAPS_SIZE) {
         ac_dprintf("TAPS OVERFLOW: CLEAR ALL STATES\n");
@@ -746,7 +889,7 @@ static void debug_registered_taps(void) {
     ac_dprintf("}\n");
 }
 
-#    endif // defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM)
+#    endif // defined(CHORDAL_HOLD) || defined(FLOW_TAP_TERM) || defined(PREDICTIVE_TAP_HOLD)
 
 #    ifdef CHORDAL_HOLD
 __attribute__((weak)) bool get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record) {
@@ -774,7 +917,7 @@ static uint8_t waiting_buffer_find_chordal_hold_tap(void) {
     keyrecord_t *prev         = &tapping_key;
     uint16_t     prev_keycode = get_record_keycode(&tapping_key, false);
     uint8_t      first_tap    = WAITING_BUFFER_SIZE;
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         keyrecord_t *  cur         = &waiting_buffer[i];
         const uint16_t cur_keycode = get_record_keycode(cur, false);
         if (!cur->event.pressed || !is_mt_or_lt(prev_keycode)) {
@@ -797,7 +940,7 @@ static void waiting_buffer_chordal_hold_taps_until(keypos_t key) {
             registered_taps_add(record->event.key);
         }
         process_record(record);
-        waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+        waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail);
 
         if (KEYEQ(key, record->event.key) && record->event.pressed) {
             break;
@@ -806,7 +949,7 @@ static void waiting_buffer_chordal_hold_taps_until(keypos_t key) {
 }
 
 static void waiting_buffer_process_regular(void) {
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
         if (is_tap_record(&waiting_buffer[waiting_buffer_tail])) {
             break; // Stop once a tap-hold key event is reached.
         }
@@ -911,6 +1054,223 @@ __attribute__((weak)) uint16_t get_flow_tap_term(uint16_t keycode, keyrecord_t *
 }
 #    endif // FLOW_TAP_TERM
 
+#    ifdef PREDICTIVE_TAP_HOLD
+__attribute__((weak)) bool get_predictive_tap_hold(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+/** Returns the statistics of `key`, creating them in place of the least used entry if `create` is set. */
+static predictive_tap_hold_stats_t *predictive_stats_find(keypos_t key, bool create) {
+    predictive_tap_hold_stats_t *least = NULL;
+    for (uint8_t i = 0; i < predictive_stats_count; ++i) {
+        if (KEYEQ(predictive_stats[i].key, key)) {
+            return &predictive_stats[i];
+        }
+        if (least == NULL || predictive_stats[i].taps + predictive_stats[i].chords < least->taps + least->chords) {
+            least = &predictive_stats[i];
+        }
+    }
+    if (!create) {
+        return NULL;
+    }
+    if (predictive_stats_count < PREDICTIVE_TAP_HOLD_KEYS) {
+        least = &predictive_stats[predictive_stats_count++];
+    }
+    *least = (predictive_tap_hold_stats_t){.key = key};
+    return least;
+}
+
+static void predictive_stats_add(uint16_t *mean, uint16_t *deviation, uint8_t *count, uint16_t ms) {
+    const int32_t sample = (int32_t)MIN(ms, 4000) * 16;
+    if (*count == 0) {
+        // Until there is a spread to measure, assume a wide one
+        *mean      = sample;
+        *deviation = sample / 4;
+    } else {
+        // Plain average over the first samples, then exponentially weighted
+        const int32_t weight = MIN(*count + 1, 16);
+        const int32_t error  = sample - *mean;
+        *mean += error / weight;
+        *deviation += ((error < 0 ? -error : error) - *deviation) / weight;
+    }
+    if (*count < UINT8_MAX) {
+        ++*count;
+    }
+    predictive_term.valid = false;
+}
+
+static bool predictive_tap_hold_enabled(uint16_t keycode) {
+    return is_mt_or_lt(keycode) && get_predictive_tap_hold(keycode, &tapping_key);
+}
+
+static uint16_t predictive_tapping_term_compute(void) {
+    const uint16_t tapping_keycode = get_record_keycode(&tapping_key, false);
+    const uint16_t term            = GET_TAPPING_TERM(tapping_keycode, &tapping_key);
+    if (tapping_key.tap.count > 0 || !predictive_tap_hold_enabled(tapping_keycode)) {
+        return term;
+    }
+
+    const predictive_tap_hold_stats_t *stats = predictive_stats_find(tapping_key.event.key, false);
+    if (stats == NULL || stats->taps < PREDICTIVE_TAP_HOLD_MIN_SAMPLES) {
+        return term;
+    }
+    const uint32_t predicted = ((uint32_t)stats->tap_mean + PREDICTIVE_TAP_HOLD_DEVIATIONS * stats->tap_deviation) / 16 + 1;
+    return MIN(MAX(predicted, PREDICTIVE_TAP_HOLD_MIN_TERM), term);
+}
+
+static uint16_t predictive_tapping_term(void) {
+    if (!predictive_term.valid || !KEYEQ(predictive_term.key, tapping_key.event.key) || predictive_term.time != tapping_key.event.time || predictive_term.count != tapping_key.tap.count) {
+        predictive_term.key   = tapping_key.event.key;
+        predictive_term.time  = tapping_key.event.time;
+        predictive_term.count = tapping_key.tap.count;
+        predictive_term.term  = predictive_tapping_term_compute();
+        predictive_term.valid = true;
+    }
+    return predictive_term.term;
+}
+
+static bool predictive_tap_hold_predicts_tap(uint16_t tapping_keycode, keyrecord_t *other) {
+    if (!predictive_tap_hold_enabled(tapping_keycode)) {
+        return false;
+    }
+
+    const predictive_tap_hold_stats_t *stats = predictive_stats_find(tapping_key.event.key, false);
+    if (stats == NULL || stats->chords < PREDICTIVE_TAP_HOLD_MIN_SAMPLES) {
+        return false;
+    }
+    const uint32_t margin = PREDICTIVE_TAP_HOLD_DEVIATIONS * stats->chord_deviation;
+    const uint32_t gap    = (uint32_t)TIMER_DIFF_16(other->event.time, tapping_key.event.time) * 16;
+    return stats->chord_mean > margin && gap < stats->chord_mean - margin;
+}
+
+static void predictive_tap_hold_settled(predictive_outcome_t outcome, uint16_t time) {
+    const uint16_t tapping_keycode = get_record_keycode(&tapping_key, false);
+    if (!is_mt_or_lt(tapping_keycode)) {
+        return;
+    }
+
+    const uint16_t elapsed = TIMER_DIFF_16(time, tapping_key.event.time);
+    if (outcome == PREDICTIVE_TAP) {
+        predictive_tap_hold_stats_t *stats = predictive_stats_find(tapping_key.event.key, true);
+        predictive_stats_add(&stats->tap_mean, &stats->tap_deviation, &stats->taps, elapsed);
+        return;
+    }
+
+    predictive_pending.key          = tapping_key.event.key;
+    predictive_pending.time         = tapping_key.event.time;
+    predictive_pending.tapping_term = GET_TAPPING_TERM(tapping_keycode, &tapping_key);
+    predictive_pending.gap          = elapsed;
+    predictive_pending.outcome      = outcome;
+}
+
+static void predictive_tap_hold_track(keyrecord_t *record) {
+    const keyevent_t event = record->event;
+    if (predictive_pending.outcome == PREDICTIVE_NONE || !IS_EVENT(event)) {
+        return;
+    }
+
+    const uint16_t elapsed = TIMER_DIFF_16(event.time, predictive_pending.time);
+    if (KEYEQ(event.key, predictive_pending.key)) {
+        if (event.pressed) {
+            return;
+        }
+        predictive_tap_hold_stats_t *stats = predictive_stats_find(predictive_pending.key, true);
+        if (predictive_pending.outcome == PREDICTIVE_EARLY_HOLD && elapsed < predictive_pending.tapping_term) {
+            // Released alone within the tapping term, this was a long tap,
+            // learn from it so that the prediction makes room for it.
+            ac_dprintf("Predictive tap-hold: early hold was a tap\n");
+            predictive_stats_add(&stats->tap_mean, &stats->tap_deviation, &stats->taps, elapsed);
+        } else if (predictive_pending.outcome == PREDICTIVE_EARLY_TAP && elapsed >= predictive_pending.tapping_term) {
+            // Held well past the tapping term, this was meant as a chord.
+            ac_dprintf("Predictive tap-hold: early tap was a hold\n");
+            predictive_stats_add(&stats->chord_mean, &stats->chord_deviation, &stats->chords, predictive_pending.gap);
+        }
+        predictive_pending.outcome = PREDICTIVE_NONE;
+    } else if (event.pressed && predictive_pending.outcome != PREDICTIVE_EARLY_TAP) {
+        // The first key pressed while the held key is down
+        predictive_tap_hold_stats_t *stats = predictive_stats_find(predictive_pending.key, true);
+        predictive_stats_add(&stats->chord_mean, &stats->chord_deviation, &stats->chords, elapsed);
+        predictive_pending.outcome = PREDICTIVE_NONE;
+    }
+}
+
+const predictive_tap_hold_stats_t *predictive_tap_hold_get_stats(uint8_t *count) {
+    *count = predictive_stats_count;
+    return predictive_stats;
+}
+
+void predictive_tap_hold_set_stats(const predictive_tap_hold_stats_t *stats, uint8_t count) {
+    predictive_stats_count = MIN(count, PREDICTIVE_TAP_HOLD_KEYS);
+    memcpy(predictive_stats, stats, predictive_stats_count * sizeof(predictive_tap_hold_stats_t));
+    predictive_term.valid = false;
+}
+
+void predictive_tap_hold_reset(void) {
+    predictive_stats_count     = 0;
+    predictive_pending.outcome = PREDICTIVE_NONE;
+    predictive_term.valid      = false;
+}
+#    endif // PREDICTIVE_TAP_HOLD
+
+#    if defined(SPECULATIVE_HOLD)
+__attribute__((weak)) bool get_speculative_hold(uint16_t keycode, keyrecord_t *record) {
+    const uint8_t mods = QK_MOD_TAP_GET_MODS(keycode);
+    return (mods & ~(MOD_RCTL | MOD_RSFT)) == 0;
+}
+
+static void speculative_hold_press(keyrecord_t *record) {
+    const uint16_t keycode = get_record_keycode(record, false);
+    if (!IS_QK_MOD_TAP(keycode) || num_speculative_keys >= SPECULATIVE_KEYS_SIZE) {
+        return;
+    }
+    // Only speculate when this press becomes the tapping key. Behind an
+    // undecided tap-hold key or buffered events, earlier taps may still be
+    // replayed and must not pick up these mods.
+    if ((tapping_key.event.pressed && tapping_key.tap.count == 0) || waiting_buffer_head != waiting_buffer_tail) {
+        return;
+    }
+    // A quick tap repeats the tap keycode, there is nothing to speculate on.
+    if (IS_TAPPING_RECORD(record) && tapping_key.tap.count > 0 && WITHIN_QUICK_TAP_TERM(record->event)) {
+        return;
+    }
+    if (!get_speculative_hold(keycode, record)) {
+        return;
+    }
+
+    uint8_t mods = mod_config(QK_MOD_TAP_GET_MODS(keycode));
+    mods         = (mods & 0x10) ? (mods & 0xF) << 4 : mods;
+    // Mods that are already active are left alone, and not retracted later.
+    mods &= ~get_mods();
+    if (mods == 0) {
+        return;
+    }
+
+    ac_dprintf("Speculative hold: mods 0x%02X\n", mods);
+    speculative_keys[num_speculative_keys].key  = record->event.key;
+    speculative_keys[num_speculative_keys].mods = mods;
+    ++num_speculative_keys;
+    add_mods(mods);
+    send_keyboard_report();
+}
+
+void speculative_hold_settled(keyrecord_t *record) {
+    for (uint8_t i = 0; i < num_speculative_keys; ++i) {
+        if (KEYEQ(speculative_keys[i].key, record->event.key)) {
+            // When held, the mod-tap action registers the same mods and
+            // releases them with the key, so only a tap needs retracting.
+            if (!record->event.pressed || record->tap.count > 0) {
+                ac_dprintf("Speculative hold: retract mods 0x%02X\n", speculative_keys[i].mods);
+                del_mods(speculative_keys[i].mods);
+                send_keyboard_report();
+            }
+            --num_speculative_keys;
+            speculative_keys[i] = speculative_keys[num_speculative_keys];
+            return;
+        }
+    }
+}
+#    endif // SPECULATIVE_HOLD
+
 /** \brief Logs tapping key if ACTION_DEBUG is enabled. */
 static void debug_tapping_key(void) {
     ac_dprintf("TAPPING_KEY=");
@@ -921,7 +1281,7 @@ static void debug_tapping_key(void) {
 /** \brief Logs waiting buffer if ACTION_DEBUG is enabled. */
 static void debug_waiting_buffer(void) {
     ac_dprintf("{");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         ac_dprintf(" [%u]=", i);
         debug_record(waiting_buffer[i]);
     }
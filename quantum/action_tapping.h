@@ -32,12 +32,32 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* number of key events held back while a tap-hold key is undecided, a power of two */
+#ifndef WAITING_BUFFER_SIZE
+#    define WAITING_BUFFER_SIZE 8
+#endif
+#if WAITING_BUFFER_SIZE < 2 || WAITING_BUFFER_SIZE > 128 || (WAITING_BUFFER_SIZE & (WAITING_BUFFER_SIZE - 1)) != 0
+#    error "WAITING_BUFFER_SIZE must be a power of two between 2 and 128"
+#endif
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
 void     action_tapping_process(keyrecord_t record);
+
+/** Waiting buffer usage, to size `WAITING_BUFFER_SIZE` from real typing. */
+typedef struct waiting_buffer_stats_t {
+    // Times the buffer was full and all tapping state was cleared
+    uint16_t overflows;
+    // Most events held in the buffer at once
+    uint8_t high_water;
+} waiting_buffer_stats_t;
+
+/** Returns the waiting buffer usage since startup or the last reset. */
+waiting_buffer_stats_t waiting_buffer_get_stats(void);
+
+/** Resets the waiting buffer usage counters. */
+void waiting_buffer_reset_stats(void);
 #endif
 
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
@@ -171,6 +191,90 @@ uint16_t get_flow_tap_term(uint16_t keycode, keyrecord_t *record, uint16_t prev_
 void flow_tap_update_last_event(keyrecord_t *record);
 #endif // FLOW_TAP_TERM
 
+#ifdef PREDICTIVE_TAP_HOLD
+#    ifndef PREDICTIVE_TAP_HOLD_KEYS
+#        define PREDICTIVE_TAP_HOLD_KEYS 16
+#    endif
+#    ifndef PREDICTIVE_TAP_HOLD_MIN_SAMPLES
+#        define PREDICTIVE_TAP_HOLD_MIN_SAMPLES 8
+#    endif
+#    ifndef PREDICTIVE_TAP_HOLD_DEVIATIONS
+#        define PREDICTIVE_TAP_HOLD_DEVIATIONS 3
+#    endif
+#    ifndef PREDICTIVE_TAP_HOLD_MIN_TERM
+#        define PREDICTIVE_TAP_HOLD_MIN_TERM 100
+#    endif
+
+/**
+ * Rolling timing statistics of a tap-hold key.
+ *
+ * Means and mean absolute deviations are exponentially weighted, over roughly
+ * the last 16 samples, in 1/16 ms units.
+ */
+typedef struct predictive_tap_hold_stats_t {
+    keypos_t key;
+    // Press to release of taps
+    uint16_t tap_mean;
+    uint16_t tap_deviation;
+    // Press to the next key press of holds
+    uint16_t chord_mean;
+    uint16_t chord_deviation;
+    // Sample counts, saturating
+    uint8_t taps;
+    uint8_t chords;
+} predictive_tap_hold_stats_t;
+
+/**
+ * Callback to specify the keys where Predictive Tap-Hold is enabled.
+ *
+ * The default implementation enables it for all mod-tap and layer-tap keys.
+ *
+ * @param keycode Keycode of the tap-hold key.
+ * @param record keyrecord_t of the tap-hold event.
+ * @return Whether to resolve this key early from its statistics.
+ */
+bool get_predictive_tap_hold(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * Returns the statistics table, and the number of entries in use, e.g. to
+ * save a snapshot to EEPROM.
+ */
+const predictive_tap_hold_stats_t *predictive_tap_hold_get_stats(uint8_t *count);
+
+/** Replaces the statistics table, e.g. with a snapshot restored from EEPROM. */
+void predictive_tap_hold_set_stats(const predictive_tap_hold_stats_t *stats, uint8_t count);
+
+/** Forgets all statistics. */
+void predictive_tap_hold_reset(void);
+#endif // PREDICTIVE_TAP_HOLD
+
+#ifdef SPECULATIVE_HOLD
+/**
+ * Callback to specify the mod-tap keys where Speculative Hold is enabled.
+ *
+ * With Speculative Hold, the mods of a mod-tap key are sent as soon as it is
+ * pressed, and retracted if the key settles as tapped. This should only be
+ * enabled for mods that do nothing when pressed and released alone.
+ *
+ * The default implementation of this callback corresponds to
+ *
+ *     bool get_speculative_hold(uint16_t keycode, keyrecord_t* record) {
+ *       const uint8_t mods = QK_MOD_TAP_GET_MODS(keycode);
+ *       return (mods & ~(MOD_RCTL | MOD_RSFT)) == 0;
+ *     }
+ *
+ * which enables it for mod-taps of Ctrl, Shift, or both.
+ *
+ * @param keycode Keycode of the mod-tap key.
+ * @param record keyrecord_t of the mod-tap press event.
+ * @return Whether to send the mods on press.
+ */
+bool get_speculative_hold(uint16_t keycode, keyrecord_t *record);
+
+/** Retracts or hands over speculative mods once a mod-tap key is settled. */
+void speculative_hold_settled(keyrecord_t *record);
+#endif // SPECULATIVE_HOLD
+
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
 extern uint16_t g_tapping_term;
 #endif
@@ -0,0 +1,236 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "analog_matrix.h"
+#include "eeconfig.h"
+#include "timer.h"
+
+#ifdef ANALOG_MATRIX_PINS
+#    include "analog.h"
+#endif
+
+typedef struct analog_key_state_t {
+    uint8_t  travel;
+    uint8_t  extremum; // deepest travel while pressed, shallowest while released, in rapid trigger mode
+    bool     pressed : 1;
+    bool     engaged : 1;     // rapid trigger is active until the key is fully released
+    uint8_t  range_confirm;   // consecutive scans deeper than the calibrated range
+    uint16_t range_candidate; // shallowest of those deviations
+} analog_key_state_t;
+
+static analog_matrix_eeconfig_t eeconfig;
+static analog_key_state_t       key_states[ANALOG_MATRIX_ROWS][MATRIX_COLS];
+static bool                     eeconfig_dirty      = false;
+static uint32_t                 eeconfig_last_write = 0;
+
+#ifdef ANALOG_MATRIX_PINS
+static const pin_t analog_pins[ANALOG_MATRIX_ROWS][MATRIX_COLS] = ANALOG_MATRIX_PINS;
+
+__attribute__((weak)) void analog_matrix_read_pins(const pin_t pins[], uint16_t values[], uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        values[i] = pins[i] != NO_PIN ? analogReadPin(pins[i]) : 0;
+    }
+}
+
+__attribute__((weak)) void analog_matrix_read_raw(uint16_t raw[ANALOG_MATRIX_ROWS][MATRIX_COLS]) {
+    // Both arrays are laid out row by row, so the whole half is read as one batch
+    analog_matrix_read_pins(&analog_pins[0][0], &raw[0][0], ANALOG_MATRIX_ROWS * MATRIX_COLS);
+}
+#endif
+
+__attribute__((weak)) uint8_t get_analog_actuation_point(uint8_t row, uint8_t col) {
+    return eeconfig.config.actuation_point;
+}
+
+static void mark_dirty(void) {
+    eeconfig_dirty      = true;
+    eeconfig_last_write = timer_read32();
+}
+
+void analog_matrix_flush(void) {
+    if (eeconfig_dirty) {
+        eeconfig_update_analog_matrix(&eeconfig);
+        eeconfig_dirty = false;
+    }
+}
+
+static void sample_rest(void) {
+    uint32_t sums[ANALOG_MATRIX_ROWS][MATRIX_COLS] = {0};
+    uint16_t raw[ANALOG_MATRIX_ROWS][MATRIX_COLS];
+    for (uint8_t i = 0; i < ANALOG_MATRIX_CALIBRATION_SAMPLES; i++) {
+        analog_matrix_read_raw(raw);
+        for (uint8_t row = 0; row < ANALOG_MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                sums[row][col] += raw[row][col];
+            }
+        }
+    }
+
+    for (uint8_t row = 0; row < ANALOG_MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            analog_key_calibration_t *cal  = &eeconfig.calibration[row][col];
+            uint16_t                  rest = sums[row][col] / ANALOG_MATRIX_CALIBRATION_SAMPLES;
+
+            // A key held down during startup would be read as its resting value, keep the
+            // stored value instead if the two are further apart than a quarter of the travel
+            if (cal->range >= ANALOG_MATRIX_MIN_RANGE) {
+                uint16_t drift = rest > cal->rest ? rest - cal->rest : cal->rest - rest;
+                if (drift > cal->range / 4) {
+                    continue;
+                }
+            }
+            // Ignore the sampling noise, so that an unchanged calibration isn't rewritten on every boot
+            uint16_t change = rest > cal->rest ? rest - cal->rest : cal->rest - rest;
+            if (change > ANALOG_MATRIX_REST_NOISE) {
+                cal->rest = rest;
+                mark_dirty();
+            }
+        }
+    }
+}
+
+static void load_defaults(void) {
+    memset(&eeconfig, 0, sizeof(eeconfig));
+    eeconfig.config.actuation_point           = ANALOG_MATRIX_ACTUATION_POINT;
+    eeconfig.config.rapid_trigger_sensitivity = ANALOG_MATRIX_RAPID_TRIGGER_SENSITIVITY;
+#ifdef ANALOG_MATRIX_RAPID_TRIGGER
+    eeconfig.config.rapid_trigger = true;
+#endif
+    mark_dirty();
+}
+
+void matrix_init_custom(void) {
+    if (!eeconfig_read_analog_matrix(&eeconfig)) {
+        load_defaults();
+    }
+    memset(key_states, 0, sizeof(key_states));
+    sample_rest();
+}
+
+static uint8_t key_travel(analog_key_state_t *key, analog_key_calibration_t *cal, uint16_t raw) {
+    uint16_t deviation = raw > cal->rest ? raw - cal->rest : cal->rest - raw;
+    if (deviation > cal->range) {
+        // Only extend the range to what has held for a run of consecutive scans, so outliers never reach the EEPROM
+        key->range_candidate = key->range_confirm == 0 ? deviation : MIN(key->range_candidate, deviation);
+        if (++key->range_confirm >= ANALOG_MATRIX_RANGE_CONFIRM_SCANS) {
+            cal->range         = key->range_candidate;
+            key->range_confirm = 0;
+            mark_dirty();
+        }
+    } else {
+        key->range_confirm = 0;
+    }
+    uint16_t range = MAX(cal->range, ANALOG_MATRIX_MIN_RANGE);
+    return MIN((uint32_t)deviation * ANALOG_MATRIX_TRAVEL_MAX / range, ANALOG_MATRIX_TRAVEL_MAX);
+}
+
+static bool key_update(analog_key_state_t *key, uint8_t travel, uint8_t actuation_point) {
+    uint8_t release_point = actuation_point > ANALOG_MATRIX_RELEASE_HYSTERESIS ? actuation_point - ANALOG_MATRIX_RELEASE_HYSTERESIS : 1;
+
+    key->travel = travel;
+    if (!key->engaged) {
+        if (travel >= actuation_point) {
+            key->pressed  = true;
+            key->engaged  = eeconfig.config.rapid_trigger;
+            key->extremum = travel;
+        } else if (travel < release_point) {
+            key->pressed = false;
+        }
+        return key->pressed;
+    }
+
+    // Rapid trigger, the key is fully reset once it is back above the release point
+    if (travel < release_point) {
+        key->pressed = false;
+        key->engaged = false;
+        return false;
+    }
+
+    uint8_t sensitivity = eeconfig.config.rapid_trigger_sensitivity;
+    if (key->pressed) {
+        if (travel > key->extremum) {
+            key->extremum = travel;
+        } else if (key->extremum - travel >= sensitivity) {
+            key->pressed  = false;
+            key->extremum = travel;
+        }
+    } else {
+        if (travel < key->extremum) {
+            key->extremum = travel;
+        } else if (travel - key->extremum >= sensitivity) {
+            key->pressed  = true;
+            key->extremum = travel;
+        }
+    }
+    return key->pressed;
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    uint16_t raw[ANALOG_MATRIX_ROWS][MATRIX_COLS];
+    analog_matrix_read_raw(raw);
+
+    bool changed = false;
+    for (uint8_t row = 0; row < ANALOG_MATRIX_ROWS; row++) {
+        matrix_row_t row_value = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            analog_key_state_t *key    = &key_states[row][col];
+            uint8_t             travel = key_travel(key, &eeconfig.calibration[row][col], raw[row][col]);
+            if (key_update(key, travel, get_analog_actuation_point(row, col))) {
+                row_value |= MATRIX_ROW_SHIFTER << col;
+            }
+        }
+        changed |= current_matrix[row] != row_value;
+        current_matrix[row] = row_value;
+    }
+
+    return changed;
+}
+
+void analog_matrix_task(void) {
+    if (eeconfig_dirty && timer_elapsed32(eeconfig_last_write) >= ANALOG_MATRIX_FLUSH_DELAY) {
+        analog_matrix_flush();
+    }
+}
+
+uint8_t analog_matrix_get_travel(uint8_t row, uint8_t col) {
+    return key_states[row][col].travel;
+}
+
+uint8_t analog_matrix_get_actuation_point(void) {
+    return eeconfig.config.actuation_point;
+}
+
+void analog_matrix_set_actuation_point(uint8_t point) {
+    eeconfig.config.actuation_point = MAX(point, 1);
+    mark_dirty();
+}
+
+bool analog_matrix_get_rapid_trigger(void) {
+    return eeconfig.config.rapid_trigger;
+}
+
+void analog_matrix_set_rapid_trigger(bool enable) {
+    eeconfig.config.rapid_trigger = enable;
+    mark_dirty();
+}
+
+uint8_t analog_matrix_get_rapid_trigger_sensitivity(void) {
+    return eeconfig.config.rapid_trigger_sensitivity;
+}
+
+void analog_matrix_set_rapid_trigger_sensitivity(uint8_t sensitivity) {
+    eeconfig.config.rapid_trigger_sensitivity = MAX(sensitivity, 1);
+    mark_dirty();
+}
+
+void analog_matrix_recalibrate(void) {
+    for (uint8_t row = 0; row < ANALOG_MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            eeconfig.calibration[row][col].range = 0;
+        }
+    }
+    memset(key_states, 0, sizeof(key_states));
+    sample_rest();
+    mark_dirty();
+}
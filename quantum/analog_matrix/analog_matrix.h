@@ -0,0 +1,149 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "compiler_support.h"
+#include "gpio.h"
+#include "matrix.h"
+#include "util.h"
+
+/*
+    Analog matrix for hall-effect or other analog key switches.
+
+    Every scan, the raw sensor value of each key is converted into a travel
+    distance between 0 (at rest) and ANALOG_MATRIX_TRAVEL_MAX (bottomed out)
+    using the key's calibration, then turned into a pressed/released state:
+
+      - a key is pressed once its travel reaches the actuation point, and
+        released once it falls ANALOG_MATRIX_RELEASE_HYSTERESIS below it,
+      - with rapid trigger enabled, a pressed key is also released as soon as it
+        moves up by the rapid trigger sensitivity, and pressed again as soon as
+        it moves down by the same amount, regardless of the actuation point.
+
+    The resting value of each key is sampled on startup, while the bottomed out
+    value is learned from the deepest press seen so far. A deeper press is only
+    learned once it has been seen for ANALOG_MATRIX_RANGE_CONFIRM_SCANS scans in
+    a row, so a single noisy sample can't stretch the calibration. Both are
+    stored in the EEPROM together with the actuation settings.
+*/
+
+#define ANALOG_MATRIX_TRAVEL_MAX 255
+
+#ifndef ANALOG_MATRIX_ACTUATION_POINT
+#    define ANALOG_MATRIX_ACTUATION_POINT 128
+#endif
+
+#ifndef ANALOG_MATRIX_RELEASE_HYSTERESIS
+#    define ANALOG_MATRIX_RELEASE_HYSTERESIS 16
+#endif
+
+#ifndef ANALOG_MATRIX_RAPID_TRIGGER_SENSITIVITY
+#    define ANALOG_MATRIX_RAPID_TRIGGER_SENSITIVITY 16
+#endif
+
+// Smallest raw deviation considered a full key press, until a deeper press has been seen
+#ifndef ANALOG_MATRIX_MIN_RANGE
+#    define ANALOG_MATRIX_MIN_RANGE 200
+#endif
+
+// Consecutive scans a deeper press has to be seen for before the range is extended
+#ifndef ANALOG_MATRIX_RANGE_CONFIRM_SCANS
+#    define ANALOG_MATRIX_RANGE_CONFIRM_SCANS 8
+#endif
+
+#ifndef ANALOG_MATRIX_CALIBRATION_SAMPLES
+#    define ANALOG_MATRIX_CALIBRATION_SAMPLES 16
+#endif
+
+// Largest change of a sampled resting value which is treated as noise, and not stored
+#ifndef ANALOG_MATRIX_REST_NOISE
+#    define ANALOG_MATRIX_REST_NOISE 4
+#endif
+
+// Quiet period after the last calibration change before it is written back to EEPROM
+#ifndef ANALOG_MATRIX_FLUSH_DELAY
+#    define ANALOG_MATRIX_FLUSH_DELAY 5000
+#endif
+
+#ifdef SPLIT_KEYBOARD
+#    define ANALOG_MATRIX_ROWS (MATRIX_ROWS / 2)
+#else
+#    define ANALOG_MATRIX_ROWS (MATRIX_ROWS)
+#endif
+
+typedef struct PACKED analog_key_calibration_t {
+    uint16_t rest;  // raw value with the key released
+    uint16_t range; // largest raw deviation from rest seen so far
+} analog_key_calibration_t;
+
+typedef union analog_matrix_config_t {
+    uint32_t raw;
+    struct PACKED {
+        uint8_t actuation_point;
+        uint8_t rapid_trigger_sensitivity;
+        bool    rapid_trigger : 1;
+        uint16_t reserved : 15;
+    };
+} analog_matrix_config_t;
+
+STATIC_ASSERT(sizeof(analog_matrix_config_t) == sizeof(uint32_t), "analog_matrix_config_t size mismatch");
+
+typedef struct PACKED analog_matrix_eeconfig_t {
+    analog_matrix_config_t   config;
+    analog_key_calibration_t calibration[MATRIX_ROWS][MATRIX_COLS];
+} analog_matrix_eeconfig_t;
+
+/**
+ * \brief Reads the raw sensor value of every key of this half.
+ *
+ * A default implementation sampling one ADC pin per key is provided when
+ * ANALOG_MATRIX_PINS is defined, it reads all of them with a single call to
+ * analog_matrix_read_pins(). Boards using multiplexers provide their own.
+ */
+void analog_matrix_read_raw(uint16_t raw[ANALOG_MATRIX_ROWS][MATRIX_COLS]);
+
+/**
+ * \brief Reads a batch of ADC pins, used by the default analog_matrix_read_raw().
+ *
+ * The default implementation calls analogReadPin() once per pin. Boards can
+ * override it to convert all of the pins in one ADC scan group, for example
+ * with DMA. Entries of NO_PIN must read as 0.
+ */
+#ifdef ANALOG_MATRIX_PINS
+void analog_matrix_read_pins(const pin_t pins[], uint16_t values[], uint16_t count);
+#endif
+
+/**
+ * \brief Returns the actuation point of a key, defaults to the configured global actuation point.
+ */
+uint8_t get_analog_actuation_point(uint8_t row, uint8_t col);
+
+/**
+ * \brief Returns the travel of a key as of the last scan, from 0 to ANALOG_MATRIX_TRAVEL_MAX.
+ */
+uint8_t analog_matrix_get_travel(uint8_t row, uint8_t col);
+
+uint8_t analog_matrix_get_actuation_point(void);
+void    analog_matrix_set_actuation_point(uint8_t point);
+bool    analog_matrix_get_rapid_trigger(void);
+void    analog_matrix_set_rapid_trigger(bool enable);
+uint8_t analog_matrix_get_rapid_trigger_sensitivity(void);
+void    analog_matrix_set_rapid_trigger_sensitivity(uint8_t sensitivity);
+
+/**
+ * \brief Forgets the learned bottom out values, and resamples the resting values. All keys must be released.
+ */
+void analog_matrix_recalibrate(void);
+
+/**
+ * \brief Writes any pending calibration changes to EEPROM.
+ */
+void analog_matrix_flush(void);
+
+/**
+ * \brief Writes pending calibration changes once they have been quiet for ANALOG_MATRIX_FLUSH_DELAY. Invoked from housekeeping_task().
+ */
+void analog_matrix_task(void);
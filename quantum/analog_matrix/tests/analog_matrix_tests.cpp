@@ -0,0 +1,217 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern "C" {
+#include "../analog_matrix.h"
+
+void matrix_init_custom(void);
+bool matrix_scan_custom(matrix_row_t current_matrix[]);
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+static uint16_t                 raw_values[ANALOG_MATRIX_ROWS][MATRIX_COLS];
+static analog_matrix_eeconfig_t stored;
+static bool                     stored_valid;
+static int                      store_count;
+
+void analog_matrix_read_raw(uint16_t raw[ANALOG_MATRIX_ROWS][MATRIX_COLS]) {
+    memcpy(raw, raw_values, sizeof(raw_values));
+}
+
+bool eeconfig_read_analog_matrix(analog_matrix_eeconfig_t *config) {
+    if (stored_valid) {
+        memcpy(config, &stored, sizeof(stored));
+    }
+    return stored_valid;
+}
+
+void eeconfig_update_analog_matrix(const analog_matrix_eeconfig_t *config) {
+    memcpy(&stored, config, sizeof(stored));
+    stored_valid = true;
+    store_count++;
+}
+}
+
+static const uint16_t REST = 1000;
+
+class AnalogMatrixTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        stored_valid = false;
+        store_count  = 0;
+        set_time(0);
+        for (auto &row : raw_values) {
+            for (auto &value : row) {
+                value = REST;
+            }
+        }
+        matrix_init_custom();
+        memset(matrix, 0, sizeof(matrix));
+    }
+
+    // Moves key (0, 0) to the given travel, with a full press being 400 raw counts away from rest
+    bool press_to(uint8_t travel) {
+        raw_values[0][0] = REST + (uint32_t)travel * 400 / ANALOG_MATRIX_TRAVEL_MAX;
+        matrix_scan_custom(matrix);
+        return matrix[0] & 1;
+    }
+
+    void learn_full_travel() {
+        for (int i = 0; i < ANALOG_MATRIX_RANGE_CONFIRM_SCANS; i++) {
+            press_to(ANALOG_MATRIX_TRAVEL_MAX);
+        }
+        press_to(0);
+    }
+
+    matrix_row_t matrix[ANALOG_MATRIX_ROWS];
+};
+
+TEST_F(AnalogMatrixTest, ActuatesAtActuationPointWithHysteresis) {
+    learn_full_travel();
+    analog_matrix_set_rapid_trigger(false);
+
+    EXPECT_FALSE(press_to(ANALOG_MATRIX_ACTUATION_POINT - 2));
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_ACTUATION_POINT + 1));
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_TRAVEL_MAX));
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_ACTUATION_POINT - ANALOG_MATRIX_RELEASE_HYSTERESIS + 2));
+    EXPECT_FALSE(press_to(ANALOG_MATRIX_ACTUATION_POINT - ANALOG_MATRIX_RELEASE_HYSTERESIS - 2));
+    EXPECT_FALSE(press_to(ANALOG_MATRIX_ACTUATION_POINT - 2));
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_ACTUATION_POINT + 1));
+}
+
+TEST_F(AnalogMatrixTest, RapidTriggerFollowsDirectionChanges) {
+    learn_full_travel();
+    analog_matrix_set_rapid_trigger(true);
+    analog_matrix_set_rapid_trigger_sensitivity(20);
+
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_ACTUATION_POINT + 2));
+    EXPECT_TRUE(press_to(200));
+    // Moving up by less than the sensitivity keeps the key pressed
+    EXPECT_TRUE(press_to(185));
+    // ...and beyond it releases, well above the actuation point
+    EXPECT_FALSE(press_to(176));
+    EXPECT_FALSE(press_to(170));
+    EXPECT_FALSE(press_to(185));
+    // Moving back down by the sensitivity presses it again
+    EXPECT_TRUE(press_to(194));
+    // Fully released resets rapid trigger, the actuation point applies again
+    EXPECT_FALSE(press_to(ANALOG_MATRIX_ACTUATION_POINT - ANALOG_MATRIX_RELEASE_HYSTERESIS - 2));
+    EXPECT_FALSE(press_to(ANALOG_MATRIX_ACTUATION_POINT - 4));
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_ACTUATION_POINT + 2));
+}
+
+TEST_F(AnalogMatrixTest, TravelFollowsCalibrationInBothDirections) {
+    // Until a full press has been seen, ANALOG_MATRIX_MIN_RANGE counts as full travel
+    raw_values[0][1] = REST - 150;
+    matrix_scan_custom(matrix);
+    EXPECT_EQ(analog_matrix_get_travel(0, 1), 150 * ANALOG_MATRIX_TRAVEL_MAX / ANALOG_MATRIX_MIN_RANGE);
+    EXPECT_EQ(matrix[0], 1 << 1);
+
+    // The range grows in steps of ANALOG_MATRIX_RANGE_CONFIRM_SCANS scans, the first of which included the shallower press
+    raw_values[0][1] = REST - 400;
+    for (int i = 0; i < 2 * ANALOG_MATRIX_RANGE_CONFIRM_SCANS; i++) {
+        matrix_scan_custom(matrix);
+    }
+    EXPECT_EQ(analog_matrix_get_travel(0, 1), ANALOG_MATRIX_TRAVEL_MAX);
+
+    raw_values[0][1] = REST - 100;
+    matrix_scan_custom(matrix);
+    EXPECT_NEAR(analog_matrix_get_travel(0, 1), ANALOG_MATRIX_TRAVEL_MAX / 4, 1);
+    EXPECT_EQ(analog_matrix_get_travel(1, 2), 0);
+}
+
+TEST_F(AnalogMatrixTest, CalibrationIsStoredAfterQuietPeriod) {
+    learn_full_travel();
+    analog_matrix_task();
+    EXPECT_EQ(store_count, 0);
+
+    // Scanning alone never writes to EEPROM
+    advance_time(ANALOG_MATRIX_FLUSH_DELAY);
+    matrix_scan_custom(matrix);
+    EXPECT_EQ(store_count, 0);
+
+    analog_matrix_task();
+    ASSERT_EQ(store_count, 1);
+    EXPECT_EQ(stored.calibration[0][0].rest, REST);
+    EXPECT_EQ(stored.calibration[0][0].range, 400);
+    EXPECT_EQ(stored.config.actuation_point, ANALOG_MATRIX_ACTUATION_POINT);
+
+    // Nothing changed, nothing written
+    advance_time(ANALOG_MATRIX_FLUSH_DELAY);
+    analog_matrix_task();
+    EXPECT_EQ(store_count, 1);
+}
+
+TEST_F(AnalogMatrixTest, OutliersDoNotExtendCalibration) {
+    learn_full_travel();
+    analog_matrix_flush();
+    ASSERT_EQ(store_count, 1);
+
+    // Spikes shorter than the confirmation run are ignored, and nothing is written back
+    raw_values[0][0] = REST + 1000;
+    for (int i = 0; i < ANALOG_MATRIX_RANGE_CONFIRM_SCANS - 1; i++) {
+        matrix_scan_custom(matrix);
+    }
+    raw_values[0][0] = REST;
+    matrix_scan_custom(matrix);
+    raw_values[0][0] = REST + 1000;
+    matrix_scan_custom(matrix);
+    EXPECT_FALSE(press_to(0));
+    advance_time(ANALOG_MATRIX_FLUSH_DELAY);
+    analog_matrix_task();
+    EXPECT_EQ(store_count, 1);
+    EXPECT_EQ(stored.calibration[0][0].range, 400);
+
+    // A sustained deeper press is learned, to the shallowest value seen while it was held
+    raw_values[0][0] = REST + 520;
+    matrix_scan_custom(matrix);
+    raw_values[0][0] = REST + 500;
+    for (int i = 0; i < ANALOG_MATRIX_RANGE_CONFIRM_SCANS - 1; i++) {
+        matrix_scan_custom(matrix);
+    }
+    press_to(0);
+    advance_time(ANALOG_MATRIX_FLUSH_DELAY);
+    analog_matrix_task();
+    EXPECT_EQ(store_count, 2);
+    EXPECT_EQ(stored.calibration[0][0].range, 500);
+}
+
+TEST_F(AnalogMatrixTest, KeyHeldAtStartupKeepsStoredRest) {
+    learn_full_travel();
+    analog_matrix_flush();
+
+    // Restart while the key is held halfway down
+    raw_values[0][0] = REST + 200;
+    matrix_init_custom();
+    EXPECT_EQ(analog_matrix_get_travel(0, 0), 0);
+    EXPECT_TRUE(press_to(ANALOG_MATRIX_TRAVEL_MAX / 2 + 2));
+    EXPECT_FALSE(press_to(0));
+
+    // A small drift of the resting value is picked up
+    raw_values[0][0] = REST + 20;
+    matrix_init_custom();
+    analog_matrix_flush();
+    EXPECT_EQ(stored.calibration[0][0].rest, REST + 20);
+}
+
+TEST_F(AnalogMatrixTest, RestNoiseIsNotStored) {
+    learn_full_travel();
+    analog_matrix_flush();
+    ASSERT_EQ(store_count, 1);
+
+    // Restart with every resting value slightly off
+    for (auto &row : raw_values) {
+        for (auto &value : row) {
+            value = REST + ANALOG_MATRIX_REST_NOISE;
+        }
+    }
+    matrix_init_custom();
+    advance_time(ANALOG_MATRIX_FLUSH_DELAY);
+    analog_matrix_task();
+    EXPECT_EQ(store_count, 1);
+    EXPECT_EQ(stored.calibration[0][0].rest, REST);
+}
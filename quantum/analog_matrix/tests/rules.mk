@@ -0,0 +1,7 @@
+analog_matrix_DEFS := -DMATRIX_ROWS=2 -DMATRIX_COLS=3 -DANALOG_MATRIX_ENABLE -DNO_DEBUG
+
+analog_matrix_SRC := \
+	$(QUANTUM_PATH)/analog_matrix/tests/analog_matrix_tests.cpp \
+	$(QUANTUM_PATH)/analog_matrix/analog_matrix.c \
+	$(PLATFORM_PATH)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
@@ -84,6 +84,10 @@ uint8_t biton16(uint16_t bits) {
 }
 
 uint8_t biton32(uint32_t bits) {
+#if !defined(__AVR__) && defined(__GNUC__)
+    // a single count leading zeros instruction on most ARM and RISC-V cores
+    return bits ? 31 - __builtin_clz(bits) : 0;
+#else
     uint8_t n = 0;
     if (bits >> 16) {
         bits >>= 16;
@@ -106,6 +110,14 @@ uint8_t biton32(uint32_t bits) {
         n += 1;
     }
     return n;
+#endif
+}
+
+uint8_t biton64(uint64_t bits) {
+    if (bits >> 32) {
+        return 32 + biton32(bits >> 32);
+    }
+    return biton32((uint32_t)bits);
 }
 
 __attribute__((noinline)) uint8_t bitrev(uint8_t bits) {
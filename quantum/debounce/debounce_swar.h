@@ -0,0 +1,62 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+SWAR helpers for debounce algorithms with one 8-bit counter per row. Four
+counters are packed into each 32-bit word, least significant lane first, so
+they can be updated with a handful of branch-free operations per word rather
+than a compare and branch per row.
+
+The packed counters only pay off where 32-bit arithmetic is native, so
+DEBOUNCE_SWAR is only defined by default on 32-bit (and wider) targets. On 8
+and 16-bit targets such as AVR the algorithms keep one counter per row. Define
+DEBOUNCE_NO_SWAR to use the per-row counters everywhere.
+*/
+
+#if !defined(DEBOUNCE_SWAR) && !defined(DEBOUNCE_NO_SWAR) && UINTPTR_MAX > UINT16_MAX
+#    define DEBOUNCE_SWAR
+#endif
+
+#if defined(__ARM_FEATURE_SIMD32)
+#    include <arm_acle.h>
+#endif
+
+#define DEBOUNCE_SWAR_LANES 4
+#define DEBOUNCE_SWAR_WORDS(num_rows) (((num_rows) + DEBOUNCE_SWAR_LANES - 1) / DEBOUNCE_SWAR_LANES)
+#define DEBOUNCE_SWAR_BROADCAST(value) ((uint32_t)(uint8_t)(value) * UINT32_C(0x01010101))
+#define DEBOUNCE_SWAR_LANE_HIGH_BIT(lane) (UINT32_C(0x80) << ((lane) * 8))
+#define DEBOUNCE_SWAR_HIGH_BITS UINT32_C(0x80808080)
+#define DEBOUNCE_SWAR_LOW_BITS UINT32_C(0x7F7F7F7F)
+
+/**
+ * \brief Expands lane high bits, as returned by debounce_swar_nonzero(), into full 0xFF lane masks.
+ */
+static inline uint32_t debounce_swar_lane_mask(uint32_t high_bits) {
+    uint32_t lanes = high_bits >> 7;
+    return (lanes << 8) - lanes;
+}
+
+/**
+ * \brief Sets the high bit of every lane which is non-zero.
+ */
+static inline uint32_t debounce_swar_nonzero(uint32_t x) {
+    return (((x & DEBOUNCE_SWAR_LOW_BITS) + DEBOUNCE_SWAR_LOW_BITS) | x) & DEBOUNCE_SWAR_HIGH_BITS;
+}
+
+/**
+ * \brief Per-lane unsigned subtraction, clamped at zero.
+ */
+static inline uint32_t debounce_swar_sub_sat(uint32_t x, uint32_t y) {
+#if defined(__ARM_FEATURE_SIMD32)
+    return __uqsub8(x, y);
+#else
+    // Subtract without letting borrows cross lanes, then clear every lane which borrowed
+    uint32_t diff   = ((x | DEBOUNCE_SWAR_HIGH_BITS) - (y & DEBOUNCE_SWAR_LOW_BITS)) ^ ((x ^ ~y) & DEBOUNCE_SWAR_HIGH_BITS);
+    uint32_t borrow = ((~x & y) | (~(x ^ y) & diff)) & DEBOUNCE_SWAR_HIGH_BITS;
+    return diff & ~debounce_swar_lane_mask(borrow);
+#endif
+}
@@ -0,0 +1,50 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "timer.h"
+
+/*
+Clock for the timestamp based debounce algorithms. Timestamps are raw counter
+ticks, so differences between them stay correct across wraparound, and the
+debounce window is converted to ticks at compile time instead.
+
+ChibiOS boards use the realtime counter (DWT cycle counter on Cortex-M, the
+1MHz timer on RP2040), everything else falls back to the millisecond timer.
+A keyboard may supply its own counter by defining DEBOUNCE_TIMESTAMP() and
+DEBOUNCE_TIMESTAMP_FREQUENCY.
+*/
+
+#ifndef DEBOUNCE_US
+#    ifdef DEBOUNCE
+#        define DEBOUNCE_US ((DEBOUNCE) * 1000UL)
+#    else
+#        define DEBOUNCE_US 5000
+#    endif
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    include "chibios_config.h"
+#endif
+
+#if defined(DEBOUNCE_TIMESTAMP)
+#    ifndef DEBOUNCE_TIMESTAMP_FREQUENCY
+#        error DEBOUNCE_TIMESTAMP_FREQUENCY must be defined along with DEBOUNCE_TIMESTAMP()
+#    endif
+#elif defined(PROTOCOL_CHIBIOS) && PORT_SUPPORTS_RT == TRUE
+#    define DEBOUNCE_TIMESTAMP() ((debounce_timestamp_t)chSysGetRealtimeCounterX())
+#    define DEBOUNCE_TIMESTAMP_FREQUENCY REALTIME_COUNTER_CLOCK
+#else
+#    define DEBOUNCE_TIMESTAMP() timer_read32()
+#    define DEBOUNCE_TIMESTAMP_FREQUENCY 1000
+#endif
+
+typedef uint32_t debounce_timestamp_t;
+
+// Debounce window in counter ticks, rounded up so that it is never shorter than DEBOUNCE_US
+#define DEBOUNCE_TICKS ((debounce_timestamp_t)(((uint64_t)(DEBOUNCE_US) * (DEBOUNCE_TIMESTAMP_FREQUENCY) + 999999) / 1000000))
+
+#define debounce_timestamp_expired(now, start) ((debounce_timestamp_t)((now) - (start)) >= DEBOUNCE_TICKS)
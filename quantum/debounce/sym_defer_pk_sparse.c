@@ -0,0 +1,153 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm with the same behaviour as sym_defer_pk.
+Only keys which are currently bouncing are tracked, in a list of
+{row, col, counter} entries plus a per-row bitmap of the listed keys. Each
+scan costs one word-wide comparison per row, plus work proportional to the
+number of keys in flight, rather than a sweep over every key in the matrix.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+#if MATRIX_COLS > 16
+#    define ROW_CTZ(bits) __builtin_ctzl(bits)
+#else
+#    define ROW_CTZ(bits) __builtin_ctz(bits)
+#endif
+
+typedef struct debounce_active_key_t {
+    uint8_t row;
+    uint8_t col;
+    uint8_t counter;
+} debounce_active_key_t;
+
+#if DEBOUNCE > 0
+static debounce_active_key_t *active_keys;
+static matrix_row_t          *active_rows;
+static uint16_t               active_count;
+static fast_timer_t           last_time;
+static bool                   counters_need_update;
+static bool                   cooked_changed;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    active_keys = (debounce_active_key_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_active_key_t));
+    active_rows = (matrix_row_t *)malloc(num_rows * sizeof(matrix_row_t));
+    for (uint8_t r = 0; r < num_rows; r++) {
+        active_rows[r] = 0;
+    }
+    active_count = 0;
+}
+
+void debounce_free(void) {
+    free(active_keys);
+    active_keys = NULL;
+    free(active_rows);
+    active_rows = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time) {
+    counters_need_update = false;
+    uint16_t kept        = 0;
+    for (uint16_t i = 0; i < active_count; i++) {
+        debounce_active_key_t key = active_keys[i];
+        if (key.counter <= elapsed_time) {
+            matrix_row_t col_mask    = ROW_SHIFTER << key.col;
+            matrix_row_t cooked_next = (cooked[key.row] & ~col_mask) | (raw[key.row] & col_mask);
+            cooked_changed |= cooked[key.row] ^ cooked_next;
+            cooked[key.row] = cooked_next;
+            active_rows[key.row] &= ~col_mask;
+        } else {
+            key.counter -= elapsed_time;
+            active_keys[kept++]  = key;
+            counters_need_update = true;
+        }
+    }
+    active_count = kept;
+}
+
+static void remove_active_key(uint8_t row, uint8_t col) {
+    for (uint16_t i = 0; i < active_count; i++) {
+        if (active_keys[i].row == row && active_keys[i].col == col) {
+            active_keys[i] = active_keys[--active_count];
+            return;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        // Keys which have just started to differ from cooked get a counter, keys which have bounced back lose theirs
+        matrix_row_t pending = delta ^ active_rows[row];
+        active_rows[row]     = delta;
+        for (; pending; pending &= pending - 1) {
+            uint8_t col = ROW_CTZ(pending);
+            if (delta & (ROW_SHIFTER << col)) {
+                active_keys[active_count++] = (debounce_active_key_t){.row = row, .col = col, .counter = DEBOUNCE};
+                counters_need_update        = true;
+            } else {
+                remove_active_key(row, col);
+            }
+        }
+    }
+}
+
+#else
+#    include "none.c"
+#endif
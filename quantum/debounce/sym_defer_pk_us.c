@@ -0,0 +1,97 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm with a timestamp per key. On any state change a
+key's timestamp is taken from the high resolution debounce clock, and the
+change is pushed once DEBOUNCE_US microseconds pass without a further change.
+Unlike the millisecond counters of sym_defer_pk, the window doesn't depend
+on the scan rate, and can be shorter than a millisecond.
+*/
+
+#include "debounce.h"
+#include "debounce_timestamp.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+#if MATRIX_COLS > 16
+#    define ROW_CTZ(bits) __builtin_ctzl(bits)
+#else
+#    define ROW_CTZ(bits) __builtin_ctz(bits)
+#endif
+
+#if DEBOUNCE_US > 0
+// [row * MATRIX_COLS + col] time of the key's last state change, only meaningful while it is active
+static debounce_timestamp_t *timestamps;
+// [row] keys which differ from cooked and are waiting out the debounce window
+static matrix_row_t *active_rows;
+static bool          keys_active;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    timestamps  = (debounce_timestamp_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_timestamp_t));
+    active_rows = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
+    keys_active = false;
+}
+
+void debounce_free(void) {
+    free(timestamps);
+    timestamps = NULL;
+    free(active_rows);
+    active_rows = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool cooked_changed = false;
+
+    if (!keys_active && !changed) {
+        return false;
+    }
+
+    debounce_timestamp_t now = DEBOUNCE_TIMESTAMP();
+
+    keys_active = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        const debounce_timestamp_t *row_timestamps = &timestamps[row * MATRIX_COLS];
+
+        // Push keys whose window has elapsed
+        matrix_row_t expired = 0;
+        for (matrix_row_t pending = active_rows[row]; pending; pending &= pending - 1) {
+            uint8_t col = ROW_CTZ(pending);
+            if (debounce_timestamp_expired(now, row_timestamps[col])) {
+                expired |= ROW_SHIFTER << col;
+            }
+        }
+        if (expired) {
+            matrix_row_t cooked_next = (cooked[row] & ~expired) | (raw[row] & expired);
+            cooked_changed |= cooked[row] ^ cooked_next;
+            cooked[row] = cooked_next;
+            active_rows[row] &= ~expired;
+        }
+
+        if (changed) {
+            // Keys which have just started to differ from cooked start their window, keys which bounced back stop
+            matrix_row_t delta   = raw[row] ^ cooked[row];
+            matrix_row_t started = delta & ~active_rows[row];
+            active_rows[row]     = delta;
+            for (; started; started &= started - 1) {
+                timestamps[row * MATRIX_COLS + ROW_CTZ(started)] = now;
+            }
+        }
+
+        keys_active |= active_rows[row] != 0;
+    }
+
+    return cooked_changed;
+}
+
+#else
+#    include "none.c"
+#endif
@@ -15,9 +15,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /*
 Symmetric per-row debounce algorithm. Changes only apply when
 DEBOUNCE milliseconds have elapsed since the last change.
+On 32-bit targets, countdowns are packed four to a 32-bit word and counted
+down together.
 */
 
 #include "debounce.h"
+#include "debounce_swar.h"
 #include "timer.h"
 #include <stdlib.h>
 
@@ -26,14 +29,23 @@ DEBOUNCE milliseconds have elapsed since the last change.
 #endif
 
 static uint16_t last_time;
+#ifdef DEBOUNCE_SWAR
+// [row / 4] packed milliseconds until key's state is considered debounced.
+static uint32_t* countdowns;
+#else
 // [row] milliseconds until key's state is considered debounced.
 static uint8_t* countdowns;
+#endif
 // [row]
 static matrix_row_t* last_raw;
 
 void debounce_init(uint8_t num_rows) {
+#ifdef DEBOUNCE_SWAR
+    countdowns = (uint32_t*)calloc(DEBOUNCE_SWAR_WORDS(num_rows), sizeof(uint32_t));
+#else
     countdowns = (uint8_t*)calloc(num_rows, sizeof(uint8_t));
-    last_raw   = (matrix_row_t*)calloc(num_rows, sizeof(matrix_row_t));
+#endif
+    last_raw = (matrix_row_t*)calloc(num_rows, sizeof(matrix_row_t));
 
     last_time = timer_read();
 }
@@ -52,6 +64,33 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     uint8_t elapsed        = (elapsed16 > 255) ? 255 : elapsed16;
     bool    cooked_changed = false;
 
+#ifdef DEBOUNCE_SWAR
+    const uint32_t elapsed_lanes = DEBOUNCE_SWAR_BROADCAST(elapsed);
+    uint8_t        row           = 0;
+
+    for (uint8_t i = 0; i < DEBOUNCE_SWAR_WORDS(num_rows); i++) {
+        // Rows which changed in this scan restart their countdown instead of counting down
+        uint32_t restarted = 0;
+        for (uint8_t lane = 0; lane < DEBOUNCE_SWAR_LANES && row < num_rows; lane++, row++) {
+            if (raw[row] != last_raw[row]) {
+                last_raw[row] = raw[row];
+                restarted |= DEBOUNCE_SWAR_LANE_HIGH_BIT(lane);
+            }
+        }
+
+        uint32_t countdown      = countdowns[i];
+        uint32_t remaining      = debounce_swar_sub_sat(countdown, elapsed_lanes);
+        uint32_t expired        = debounce_swar_nonzero(countdown) & ~debounce_swar_nonzero(remaining) & ~restarted;
+        uint32_t restarted_mask = debounce_swar_lane_mask(restarted);
+        countdowns[i]           = (remaining & ~restarted_mask) | (DEBOUNCE_SWAR_BROADCAST(DEBOUNCE) & restarted_mask);
+
+        for (; expired; expired &= expired - 1) {
+            uint8_t expired_row = i * DEBOUNCE_SWAR_LANES + __builtin_ctzl(expired) / 8;
+            cooked_changed |= cooked[expired_row] ^ raw[expired_row];
+            cooked[expired_row] = raw[expired_row];
+        }
+    }
+#else
     uint8_t* countdown = countdowns;
 
     for (uint8_t row = 0; row < num_rows; ++row, ++countdown) {
@@ -68,6 +107,7 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
             *countdown  = 0;
         }
     }
+#endif
 
     return cooked_changed;
 }
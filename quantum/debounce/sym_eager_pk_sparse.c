@@ -0,0 +1,143 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm with the same behaviour as sym_eager_pk.
+Only keys which are currently locked out are tracked, in a list of
+{row, col, counter} entries plus a per-row bitmap of the listed keys. Each
+scan costs one word-wide comparison per row, plus work proportional to the
+number of keys in flight, rather than a sweep over every key in the matrix.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#if MATRIX_COLS > 16
+#    define ROW_CTZ(bits) __builtin_ctzl(bits)
+#else
+#    define ROW_CTZ(bits) __builtin_ctz(bits)
+#endif
+
+typedef struct debounce_active_key_t {
+    uint8_t row;
+    uint8_t col;
+    uint8_t counter;
+} debounce_active_key_t;
+
+#if DEBOUNCE > 0
+static debounce_active_key_t *active_keys;
+static matrix_row_t          *active_rows;
+static uint16_t               active_count;
+static fast_timer_t           last_time;
+static bool                   counters_need_update;
+static bool                   matrix_need_update;
+static bool                   cooked_changed;
+
+static void update_debounce_counters(uint8_t elapsed_time);
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    active_keys = (debounce_active_key_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_active_key_t));
+    active_rows = (matrix_row_t *)malloc(num_rows * sizeof(matrix_row_t));
+    for (uint8_t r = 0; r < num_rows; r++) {
+        active_rows[r] = 0;
+    }
+    active_count = 0;
+}
+
+void debounce_free(void) {
+    free(active_keys);
+    active_keys = NULL;
+    free(active_rows);
+    active_rows = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters(elapsed_time);
+        }
+    }
+
+    if (changed || matrix_need_update) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        transfer_matrix_values(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+// If the current time is > debounce counter, drop the key from the active list to enable input.
+static void update_debounce_counters(uint8_t elapsed_time) {
+    counters_need_update = false;
+    matrix_need_update   = false;
+    uint16_t kept        = 0;
+    for (uint16_t i = 0; i < active_count; i++) {
+        debounce_active_key_t key = active_keys[i];
+        if (key.counter <= elapsed_time) {
+            active_rows[key.row] &= ~((matrix_row_t)1 << key.col);
+            matrix_need_update = true;
+        } else {
+            key.counter -= elapsed_time;
+            active_keys[kept++]  = key;
+            counters_need_update = true;
+        }
+    }
+    active_count = kept;
+}
+
+// upload from raw_matrix to final matrix;
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    matrix_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        // Changed keys which aren't locked out flip immediately, and are then locked out for DEBOUNCE
+        matrix_row_t ready = (raw[row] ^ cooked[row]) & ~active_rows[row];
+        if (!ready) {
+            continue;
+        }
+        active_rows[row] |= ready;
+        cooked[row] ^= ready;
+        counters_need_update = true;
+        cooked_changed       = true;
+        for (; ready; ready &= ready - 1) {
+            active_keys[active_count++] = (debounce_active_key_t){.row = row, .col = ROW_CTZ(ready), .counter = DEBOUNCE};
+        }
+    }
+}
+
+#else
+#    include "none.c"
+#endif
@@ -0,0 +1,92 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm with a timestamp per key. On any state change
+the response is immediate, and the key's timestamp is taken from the high
+resolution debounce clock. No further input is accepted for that key until
+DEBOUNCE_US microseconds have passed. Unlike the millisecond counters of
+sym_eager_pk, the window doesn't depend on the scan rate, and can be shorter
+than a millisecond.
+*/
+
+#include "debounce.h"
+#include "debounce_timestamp.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+#if MATRIX_COLS > 16
+#    define ROW_CTZ(bits) __builtin_ctzl(bits)
+#else
+#    define ROW_CTZ(bits) __builtin_ctz(bits)
+#endif
+
+#if DEBOUNCE_US > 0
+// [row * MATRIX_COLS + col] time the key last changed state, only meaningful while it is locked
+static debounce_timestamp_t *timestamps;
+// [row] keys which changed state recently and ignore input until their window has elapsed
+static matrix_row_t *locked_rows;
+static bool          keys_locked;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    timestamps  = (debounce_timestamp_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_timestamp_t));
+    locked_rows = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
+    keys_locked = false;
+}
+
+void debounce_free(void) {
+    free(timestamps);
+    timestamps = NULL;
+    free(locked_rows);
+    locked_rows = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool cooked_changed = false;
+
+    if (!keys_locked && !changed) {
+        return false;
+    }
+
+    debounce_timestamp_t now = DEBOUNCE_TIMESTAMP();
+
+    keys_locked = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        const debounce_timestamp_t *row_timestamps = &timestamps[row * MATRIX_COLS];
+
+        // Release keys whose window has elapsed
+        for (matrix_row_t pending = locked_rows[row]; pending; pending &= pending - 1) {
+            uint8_t col = ROW_CTZ(pending);
+            if (debounce_timestamp_expired(now, row_timestamps[col])) {
+                locked_rows[row] &= ~(ROW_SHIFTER << col);
+            }
+        }
+
+        // Unlocked keys which differ from cooked flip immediately, and are then locked
+        matrix_row_t ready = (raw[row] ^ cooked[row]) & ~locked_rows[row];
+        if (ready) {
+            cooked[row] ^= ready;
+            locked_rows[row] |= ready;
+            cooked_changed = true;
+            for (; ready; ready &= ready - 1) {
+                timestamps[row * MATRIX_COLS + ROW_CTZ(ready)] = now;
+            }
+        }
+
+        keys_locked |= locked_rows[row] != 0;
+    }
+
+    return cooked_changed;
+}
+
+#else
+#    include "none.c"
+#endif
@@ -17,9 +17,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 Basic per-row algorithm. Uses an 8-bit counter per row.
 After pressing a key, it immediately changes state, and sets a counter.
 No further inputs are accepted until DEBOUNCE milliseconds have occurred.
+On 32-bit targets, counters are packed four to a 32-bit word and counted down
+together.
 */
 
 #include "debounce.h"
+#include "debounce_swar.h"
 #include "timer.h"
 #include <stdlib.h>
 
@@ -39,11 +42,16 @@ No further inputs are accepted until DEBOUNCE milliseconds have occurred.
 #    define DEBOUNCE UINT8_MAX
 #endif
 
-typedef uint8_t debounce_counter_t;
-
 #if DEBOUNCE > 0
 static bool matrix_need_update;
 
+#    ifdef DEBOUNCE_SWAR
+// [row / 4] packed 8-bit counters, zero once a row has been debounced
+typedef uint32_t debounce_counter_t;
+#    else
+typedef uint8_t debounce_counter_t;
+#    endif
+
 static debounce_counter_t *debounce_counters;
 static fast_timer_t        last_time;
 static bool                counters_need_update;
@@ -56,10 +64,14 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
 
 // we use num_rows rather than MATRIX_ROWS to support split keyboards
 void debounce_init(uint8_t num_rows) {
+#    ifdef DEBOUNCE_SWAR
+    debounce_counters = (debounce_counter_t *)calloc(DEBOUNCE_SWAR_WORDS(num_rows), sizeof(debounce_counter_t));
+#    else
     debounce_counters = (debounce_counter_t *)malloc(num_rows * sizeof(debounce_counter_t));
     for (uint8_t r = 0; r < num_rows; r++) {
         debounce_counters[r] = DEBOUNCE_ELAPSED;
     }
+#    endif
 }
 
 void debounce_free(void) {
@@ -97,6 +109,47 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     return cooked_changed;
 }
 
+#    ifdef DEBOUNCE_SWAR
+// If the current time is > debounce counter, set the counter to enable input.
+static void update_debounce_counters(uint8_t num_rows, uint8_t elapsed_time) {
+    const uint32_t elapsed = DEBOUNCE_SWAR_BROADCAST(elapsed_time);
+    uint32_t       pending = 0;
+    uint32_t       expired = 0;
+    for (uint8_t i = 0; i < DEBOUNCE_SWAR_WORDS(num_rows); i++) {
+        uint32_t counters    = debounce_counters[i];
+        uint32_t remaining   = debounce_swar_sub_sat(counters, elapsed);
+        debounce_counters[i] = remaining;
+        pending |= remaining;
+        expired |= debounce_swar_nonzero(counters) & ~debounce_swar_nonzero(remaining);
+    }
+    counters_need_update = pending != 0;
+    matrix_need_update   = expired != 0;
+}
+
+// upload from raw_matrix to final matrix;
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    matrix_need_update = false;
+    uint8_t row        = 0;
+    for (uint8_t i = 0; i < DEBOUNCE_SWAR_WORDS(num_rows); i++) {
+        uint32_t idle    = ~debounce_swar_nonzero(debounce_counters[i]);
+        uint32_t started = 0;
+        for (uint8_t lane = 0; lane < DEBOUNCE_SWAR_LANES && row < num_rows; lane++, row++) {
+            matrix_row_t raw_row = raw[row];
+
+            // determine new value basd on debounce counter + raw value
+            if ((idle & DEBOUNCE_SWAR_LANE_HIGH_BIT(lane)) && cooked[row] != raw_row) {
+                cooked_changed |= cooked[row] ^ raw_row;
+                cooked[row] = raw_row;
+                started |= DEBOUNCE_SWAR_LANE_HIGH_BIT(lane);
+            }
+        }
+        if (started) {
+            debounce_counters[i] |= debounce_swar_lane_mask(started) & DEBOUNCE_SWAR_BROADCAST(DEBOUNCE);
+            counters_need_update = true;
+        }
+    }
+}
+#    else
 // If the current time is > debounce counter, set the counter to enable input.
 static void update_debounce_counters(uint8_t num_rows, uint8_t elapsed_time) {
     counters_need_update                 = false;
@@ -136,6 +189,7 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
         debounce_pointer++;
     }
 }
+#    endif
 
 #else
 #    include "none.c"
@@ -0,0 +1,43 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "../debounce_swar.h"
+}
+
+static uint8_t lane(uint32_t word, int index) {
+    return (word >> (index * 8)) & 0xFF;
+}
+
+TEST(DebounceSwar, SubSatMatchesScalarInEveryLane) {
+    for (uint32_t x = 0; x < 256; x++) {
+        for (uint32_t y = 0; y < 256; y++) {
+            // Surround the lane under test with neighbours that would leak a borrow if lanes weren't isolated
+            uint32_t xs      = DEBOUNCE_SWAR_BROADCAST(x) ^ UINT32_C(0x00FF00FF);
+            uint32_t ys      = DEBOUNCE_SWAR_BROADCAST(y) ^ UINT32_C(0xFF00FF00);
+            uint32_t result  = debounce_swar_sub_sat(xs, ys);
+            uint32_t nonzero = debounce_swar_nonzero(xs);
+            for (int i = 0; i < DEBOUNCE_SWAR_LANES; i++) {
+                uint8_t a = lane(xs, i);
+                uint8_t b = lane(ys, i);
+                ASSERT_EQ(lane(result, i), a > b ? a - b : 0) << "x=" << x << " y=" << y << " lane " << i;
+                ASSERT_EQ(!!(nonzero & DEBOUNCE_SWAR_LANE_HIGH_BIT(i)), a != 0) << "x=" << x << " lane " << i;
+            }
+        }
+    }
+}
+
+TEST(DebounceSwar, LaneMaskExpandsHighBits) {
+    for (uint32_t bits = 0; bits < 16; bits++) {
+        uint32_t high = 0, expected = 0;
+        for (int i = 0; i < DEBOUNCE_SWAR_LANES; i++) {
+            if (bits & (1 << i)) {
+                high |= DEBOUNCE_SWAR_LANE_HIGH_BIT(i);
+                expected |= UINT32_C(0xFF) << (i * 8);
+            }
+        }
+        EXPECT_EQ(debounce_swar_lane_mask(high), expected);
+    }
+}
@@ -0,0 +1,9 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// Treat the test timer as a 1MHz counter for the timestamp based algorithms
+#define DEBOUNCE_TIMESTAMP() timer_read32()
+#define DEBOUNCE_TIMESTAMP_FREQUENCY 1000000
+#define DEBOUNCE_US 300
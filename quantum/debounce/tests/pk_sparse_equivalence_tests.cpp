@@ -0,0 +1,87 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+extern "C" {
+#include "debounce.h"
+#include "timer.h"
+
+void reference_debounce_init(uint8_t num_rows);
+bool reference_debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+void reference_debounce_free(void);
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+/* Feeds the same bouncy input to the sparse algorithm and to the full-sweep
+ * algorithm it replaces, and checks that every call produces the same result. */
+static void run_equivalence(uint32_t seed, int max_step, int flip_chance, int keys_in_play) {
+    std::mt19937 rng(seed);
+
+    matrix_row_t raw[MATRIX_ROWS]              = {0};
+    matrix_row_t cooked[MATRIX_ROWS]           = {0};
+    matrix_row_t reference_cooked[MATRIX_ROWS] = {0};
+
+    std::vector<std::pair<uint8_t, uint8_t>> keys;
+    for (int i = 0; i < keys_in_play; i++) {
+        keys.emplace_back(rng() % MATRIX_ROWS, rng() % MATRIX_COLS);
+    }
+
+    set_time(1000 + seed);
+    debounce_init(MATRIX_ROWS);
+    reference_debounce_init(MATRIX_ROWS);
+
+    for (int step = 0; step < 200000; step++) {
+        bool changed = false;
+        if ((int)(rng() % 100) < flip_chance) {
+            int flips = 1 + rng() % 3;
+            for (int i = 0; i < flips; i++) {
+                auto &key = keys[rng() % keys.size()];
+                raw[key.first] ^= (matrix_row_t)1 << key.second;
+            }
+            changed = true;
+        }
+
+        bool result           = debounce(raw, cooked, MATRIX_ROWS, changed);
+        bool reference_result = reference_debounce(raw, reference_cooked, MATRIX_ROWS, changed);
+
+        ASSERT_EQ(result, reference_result) << "seed " << seed << " step " << step;
+        ASSERT_TRUE(std::equal(std::begin(cooked), std::end(cooked), std::begin(reference_cooked))) << "seed " << seed << " step " << step;
+
+        // Mostly short steps so keys bounce within DEBOUNCE, with the odd long stall
+        int r = rng() % 1000;
+        advance_time(r == 0 ? 300 + rng() % 300 : rng() % (max_step + 1));
+    }
+
+    debounce_free();
+    reference_debounce_free();
+}
+
+TEST(DebounceSparseEquivalence, FastScanFewKeys) {
+    for (uint32_t seed = 1; seed <= 4; seed++) {
+        run_equivalence(seed, 1, 20, 3);
+    }
+}
+
+TEST(DebounceSparseEquivalence, SlowScanManyKeys) {
+    for (uint32_t seed = 11; seed <= 14; seed++) {
+        run_equivalence(seed, 4, 40, MATRIX_ROWS * MATRIX_COLS);
+    }
+}
+
+TEST(DebounceSparseEquivalence, ChatteringKeys) {
+    for (uint32_t seed = 31; seed <= 34; seed++) {
+        run_equivalence(seed, 1, 50, 2);
+    }
+}
+
+TEST(DebounceSparseEquivalence, NoisyMatrix) {
+    for (uint32_t seed = 21; seed <= 24; seed++) {
+        run_equivalence(seed, 2, 90, 12);
+    }
+}
@@ -34,8 +34,16 @@ debounce_sym_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
 
-debounce_sym_defer_pr_DEFS := $(DEBOUNCE_COMMON_DEFS)
+# The per-row algorithms pack four counters per word, use enough rows for a partially filled last word
+debounce_sym_defer_pr_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=10 -DDEBOUNCE=5
 debounce_sym_defer_pr_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pr.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pr_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/debounce_swar_tests.cpp
+
+# The per-row counters used on 8 and 16-bit targets
+debounce_sym_defer_pr_no_swar_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=10 -DDEBOUNCE=5 -DDEBOUNCE_NO_SWAR
+debounce_sym_defer_pr_no_swar_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_defer_pr.c \
 	$(QUANTUM_PATH)/debounce/tests/sym_defer_pr_tests.cpp
 
@@ -44,8 +52,14 @@ debounce_sym_eager_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_eager_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp
 
-debounce_sym_eager_pr_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_pr_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=10 -DDEBOUNCE=5
 debounce_sym_eager_pr_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pr.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pr_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/debounce_swar_tests.cpp
+
+debounce_sym_eager_pr_no_swar_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=10 -DDEBOUNCE=5 -DDEBOUNCE_NO_SWAR
+debounce_sym_eager_pr_no_swar_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_eager_pr.c \
 	$(QUANTUM_PATH)/debounce/tests/sym_eager_pr_tests.cpp
 
@@ -53,3 +67,56 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+debounce_sym_defer_pk_sparse_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_pk_sparse_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_sparse.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_reference.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/pk_sparse_equivalence_tests.cpp
+
+debounce_sym_eager_pk_sparse_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_pk_sparse_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk_sparse.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_reference.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/pk_sparse_equivalence_tests.cpp
+
+# Millisecond clock, so the timestamp algorithms can be checked against the counter based pk scenarios
+debounce_sym_defer_pk_us_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_pk_us_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_us.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
+
+debounce_sym_eager_pk_us_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_pk_us_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk_us.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp
+
+DEBOUNCE_US_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -include $(QUANTUM_PATH)/debounce/tests/debounce_us_test_clock.h
+
+debounce_sym_defer_pk_us_300_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_defer_pk_us_300_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_us.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_us_tests.cpp
+
+debounce_sym_eager_pk_us_300_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_eager_pk_us_300_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk_us.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_us_tests.cpp
+
+# Benchmarks, every algorithm replays the same trace on up to 16 rows of 32 columns
+DEBOUNCE_BENCHMARK_DEFS := -DMATRIX_ROWS=16 -DMATRIX_COLS=32 -DDEBOUNCE=5
+DEBOUNCE_BENCHMARK_SRC := tests/benchmark/debounce_benchmark.cpp \
+	$(PLATFORM_PATH)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+DEBOUNCE_BENCHMARK_ALGORITHMS := none sym_defer_g sym_defer_pk sym_defer_pr sym_eager_pk sym_eager_pr asym_eager_defer_pk \
+	sym_defer_pk_sparse sym_eager_pk_sparse sym_defer_pk_us sym_eager_pk_us
+
+define DEBOUNCE_BENCHMARK
+debounce_benchmark_$1_DEFS := $$(DEBOUNCE_BENCHMARK_DEFS) -DDEBOUNCE_ALGORITHM=$1
+debounce_benchmark_$1_SRC := $$(DEBOUNCE_BENCHMARK_SRC) $$(QUANTUM_PATH)/debounce/$1.c
+endef
+
+$(foreach algorithm,$(DEBOUNCE_BENCHMARK_ALGORITHMS),$(eval $(call DEBOUNCE_BENCHMARK,$(algorithm))))
@@ -0,0 +1,34 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+/* The test clock is treated as a 1MHz counter, times below are in microseconds */
+
+TEST_F(DebounceTest, SubMillisecondWindow) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {}},
+
+        {300, {}, {{0, 1, DOWN}}},
+        {450, {{0, 1, UP}}, {}},
+
+        {750, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, SubMillisecondBouncing) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {}},
+        {120, {{0, 1, UP}}, {}},
+        {180, {{0, 1, DOWN}}, {}},
+
+        /* Window restarts from the last change */
+        {480, {}, {{0, 1, DOWN}}},
+    });
+    runEvents();
+}
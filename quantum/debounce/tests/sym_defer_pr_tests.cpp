@@ -177,6 +177,21 @@ TEST_F(DebounceTest, TwoKeysSimultaneous2) {
     runEvents();
 }
 
+TEST_F(DebounceTest, RowsAcrossCounterWords) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{3, 0, DOWN}, {4, 1, DOWN}, {9, 2, DOWN}}, {}},
+        /* Row 4 bounces back before it is debounced */
+        {2, {{4, 1, UP}}, {}},
+
+        {5, {}, {{3, 0, DOWN}, {9, 2, DOWN}}},
+        {8, {{9, 2, UP}}, {}},
+
+        {13, {}, {{9, 2, UP}}},
+    });
+    runEvents();
+}
+
 TEST_F(DebounceTest, OneKeyDelayedScan1) {
     addEvents({
         /* Time, Inputs, Outputs */
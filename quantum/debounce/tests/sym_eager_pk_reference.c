@@ -0,0 +1,8 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Builds sym_eager_pk under different names, so that it can be compared against sym_eager_pk_sparse in the same test binary
+#define debounce_init reference_debounce_init
+#define debounce reference_debounce
+#define debounce_free reference_debounce_free
+#include "../sym_eager_pk.c"
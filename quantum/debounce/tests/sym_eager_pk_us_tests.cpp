@@ -0,0 +1,35 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+/* The test clock is treated as a 1MHz counter, times below are in microseconds */
+
+TEST_F(DebounceTest, SubMillisecondWindow) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {100, {{0, 1, UP}}, {}},
+
+        {300, {}, {{0, 1, UP}}},
+        {450, {{0, 1, DOWN}}, {}},
+
+        {600, {}, {{0, 1, DOWN}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, SubMillisecondTwoKeys) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {150, {{1, 2, DOWN}}, {{1, 2, DOWN}}},
+        {200, {{0, 1, UP}, {1, 2, UP}}, {}},
+
+        {300, {}, {{0, 1, UP}}},
+        {450, {}, {{1, 2, UP}}},
+    });
+    runEvents();
+}
@@ -222,6 +222,19 @@ TEST_F(DebounceTest, TwoKeysSimultaneous2) {
     runEvents();
 }
 
+TEST_F(DebounceTest, RowsAcrossCounterWords) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{3, 0, DOWN}, {4, 1, DOWN}, {9, 2, DOWN}}, {{3, 0, DOWN}, {4, 1, DOWN}, {9, 2, DOWN}}},
+        /* Release during the lockout of row 4 only */
+        {1, {{4, 1, UP}}, {}},
+
+        {5, {}, {{4, 1, UP}}},
+        {7, {{9, 2, UP}}, {{9, 2, UP}}},
+    });
+    runEvents();
+}
+
 TEST_F(DebounceTest, OneKeyDelayedScan1) {
     addEvents({
         /* Time, Inputs, Outputs */
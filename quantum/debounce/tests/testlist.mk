@@ -3,6 +3,25 @@ TEST_LIST += \
 	debounce_sym_defer_g \
 	debounce_sym_defer_pk \
 	debounce_sym_defer_pr \
+	debounce_sym_defer_pr_no_swar \
 	debounce_sym_eager_pk \
 	debounce_sym_eager_pr \
-	debounce_asym_eager_defer_pk
+	debounce_sym_eager_pr_no_swar \
+	debounce_asym_eager_defer_pk \
+	debounce_sym_defer_pk_sparse \
+	debounce_sym_eager_pk_sparse \
+	debounce_sym_defer_pk_us \
+	debounce_sym_eager_pk_us \
+	debounce_sym_defer_pk_us_300 \
+	debounce_sym_eager_pk_us_300 \
+	debounce_benchmark_none \
+	debounce_benchmark_sym_defer_g \
+	debounce_benchmark_sym_defer_pk \
+	debounce_benchmark_sym_defer_pr \
+	debounce_benchmark_sym_eager_pk \
+	debounce_benchmark_sym_eager_pr \
+	debounce_benchmark_asym_eager_defer_pk \
+	debounce_benchmark_sym_defer_pk_sparse \
+	debounce_benchmark_sym_eager_pk_sparse \
+	debounce_benchmark_sym_defer_pk_us \
+	debounce_benchmark_sym_eager_pk_us
@@ -13,30 +13,40 @@
 // Helpers
 //
 
-static deferred_token current_token = 0;
+// Tokens carry the 1-based slot index in the low byte, so lookups don't need to search the table. The timer wheel
+// below numbers its entries the same way and reserves 0xFF, so both are limited to 254 slots.
+#define TOKEN_SLOT_MASK 0xFF
+#define TOKEN_MAX_SLOTS 254
 
-static inline bool token_can_be_used(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
-    }
-    for (int i = 0; i < table_count; ++i) {
-        if (table[i].token == token) {
-            return false;
-        }
-    }
-    return true;
+#if MAX_DEFERRED_EXECUTORS > TOKEN_MAX_SLOTS
+#    error MAX_DEFERRED_EXECUTORS must be 254 or less
+#endif
+
+static uint8_t token_serial = 0;
+
+static inline deferred_token make_token(size_t index) {
+    return (deferred_token)((((deferred_token)++token_serial) << 8) | (index + 1));
 }
 
-static inline deferred_token allocate_token(deferred_executor_t *table, size_t table_count) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(table, table_count, current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
-        }
+static inline deferred_executor_t *find_executor(deferred_executor_t *table, size_t table_count, deferred_token token) {
+    size_t slot = token & TOKEN_SLOT_MASK;
+    if (slot == 0 || slot > table_count || table[slot - 1].token != token) {
+        return NULL;
     }
-    return current_token;
+    return &table[slot - 1];
+}
+
+// Repeats are relative to the previous trigger, but never earlier than `earliest`, so that a stall doesn't cause a burst
+static inline uint32_t next_trigger_time(uint32_t trigger_time, uint32_t delay_ms, uint32_t earliest) {
+    uint32_t next = trigger_time + delay_ms;
+    return (((int32_t)TIMER_DIFF_32(next, earliest)) < 0) ? earliest : next;
+}
+
+static inline void clear_executor(deferred_executor_t *entry) {
+    entry->token        = INVALID_DEFERRED_TOKEN;
+    entry->trigger_time = 0;
+    entry->callback     = NULL;
+    entry->cb_arg       = NULL;
 }
 
 //------------------------------------
@@ -50,21 +60,18 @@ deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_coun
     }
 
     // Find an unused slot and claim it
-    for (int i = 0; i < table_count; ++i) {
+    if (table_count > TOKEN_MAX_SLOTS) {
+        table_count = TOKEN_MAX_SLOTS;
+    }
+    for (size_t i = 0; i < table_count; ++i) {
         deferred_executor_t *entry = &table[i];
         if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token(table, table_count);
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
-
             // Set up the executor table entry
-            entry->token        = current_token;
+            entry->token        = make_token(i);
             entry->trigger_time = timer_read32() + delay_ms;
             entry->callback     = callback;
             entry->cb_arg       = cb_arg;
-            return current_token;
+            return entry->token;
         }
     }
 
@@ -79,17 +86,14 @@ bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = find_executor(table, table_count, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    entry->trigger_time = timer_read32() + delay_ms;
+    return true;
 }
 
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token) {
@@ -99,20 +103,14 @@ bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    deferred_executor_t *entry = find_executor(table, table_count, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, cancel and clear the table entry
+    clear_executor(entry);
+    return true;
 }
 
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time) {
@@ -123,7 +121,7 @@ void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count,
         *last_execution_time = now;
 
         // Run through each of the executors
-        for (int i = 0; i < table_count; ++i) {
+        for (size_t i = 0; i < table_count; ++i) {
             deferred_executor_t *entry      = &table[i];
             deferred_token       curr_token = entry->token;
 
@@ -146,10 +144,7 @@ void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count,
                     entry->trigger_time += delay_ms;
                 } else {
                     // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
+                    clear_executor(entry);
                 }
             }
         }
@@ -157,21 +152,251 @@ void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count,
 }
 
 //------------------------------------
-// Basic API: used by user-mode code, guaranteed to not collide with core deferred execution
+// Timing wheel: backs the basic API, so that large numbers of user executors cost nothing per loop
+//
+// Executors live in one of WHEEL_LEVELS levels of WHEEL_SIZE buckets each, chosen by the most significant WHEEL_BITS-wide
+// digit in which their trigger time differs from the wheel's current time. Level 0 buckets hold executors due at
+// exactly that millisecond. Whenever the wheel's time crosses into a new digit at a higher level, the matching bucket is
+// cascaded down into the lower levels. Insertion, cancellation and extension are O(1), and advancing the wheel only
+// touches buckets which actually hold executors.
 //
 
-static uint32_t            last_deferred_exec_check                = 0;
-static deferred_executor_t basic_executors[MAX_DEFERRED_EXECUTORS] = {0};
+#define WHEEL_BITS 4
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS (32 / WHEEL_BITS)
+#define WHEEL_PENDING (WHEEL_LEVELS * WHEEL_SIZE) // list of executors being fired in the current tick
+#define WHEEL_DETACHED 0xFF                       // executor is currently being invoked
+#define WHEEL_NONE 0                              // links are 1-based so that zero-initialised storage is an empty wheel
+
+typedef struct deferred_wheel_entry_t {
+    deferred_executor_t executor;
+    uint8_t             next;
+    uint8_t             prev;
+    uint8_t             bucket;
+} deferred_wheel_entry_t;
+
+static deferred_wheel_entry_t wheel_entries[MAX_DEFERRED_EXECUTORS];
+static uint8_t                wheel_heads[WHEEL_PENDING + 1];
+static uint8_t                wheel_free       = WHEEL_NONE;
+static uint8_t                wheel_high_water = 0;
+static uint8_t                wheel_count      = 0;
+static uint32_t               wheel_time       = 0; // next millisecond to be processed
+
+#define WHEEL_ENTRY(link) (&wheel_entries[(link) - 1])
+
+static void wheel_link(uint8_t link, uint8_t bucket) {
+    deferred_wheel_entry_t *entry = WHEEL_ENTRY(link);
+    entry->bucket                 = bucket;
+    entry->prev                   = WHEEL_NONE;
+    entry->next                   = wheel_heads[bucket];
+    if (entry->next != WHEEL_NONE) {
+        WHEEL_ENTRY(entry->next)->prev = link;
+    }
+    wheel_heads[bucket] = link;
+}
+
+static void wheel_unlink(uint8_t link) {
+    deferred_wheel_entry_t *entry = WHEEL_ENTRY(link);
+    if (entry->bucket == WHEEL_DETACHED) {
+        return;
+    }
+    if (entry->prev != WHEEL_NONE) {
+        WHEEL_ENTRY(entry->prev)->next = entry->next;
+    } else {
+        wheel_heads[entry->bucket] = entry->next;
+    }
+    if (entry->next != WHEEL_NONE) {
+        WHEEL_ENTRY(entry->next)->prev = entry->prev;
+    }
+    entry->bucket = WHEEL_DETACHED;
+}
+
+static void wheel_insert(uint8_t link) {
+    uint32_t expires = WHEEL_ENTRY(link)->executor.trigger_time;
+
+    // Anything already overdue goes into the very next tick
+    if (((int32_t)TIMER_DIFF_32(expires, wheel_time)) < 0) {
+        expires = wheel_time;
+    }
+
+    uint8_t  level = 0;
+    uint32_t diff  = (expires ^ wheel_time) >> WHEEL_BITS;
+    while (diff) {
+        level++;
+        diff >>= WHEEL_BITS;
+    }
+    wheel_link(link, level * WHEEL_SIZE + ((expires >> (level * WHEEL_BITS)) & WHEEL_MASK));
+}
+
+static void wheel_free_entry(uint8_t link) {
+    deferred_wheel_entry_t *entry = WHEEL_ENTRY(link);
+    clear_executor(&entry->executor);
+    entry->bucket = WHEEL_DETACHED;
+    entry->next   = wheel_free;
+    wheel_free    = link;
+    wheel_count--;
+}
+
+static uint8_t wheel_find(deferred_token token) {
+    uint8_t link = token & TOKEN_SLOT_MASK;
+    if (link == WHEEL_NONE || link > wheel_high_water || WHEEL_ENTRY(link)->executor.token != token) {
+        return WHEEL_NONE;
+    }
+    return link;
+}
+
+// Lower bound on the next tick which has work to do, either firing executors or cascading a non-empty bucket
+static bool wheel_next_event(uint32_t *next) {
+    for (uint8_t level = 0; level < WHEEL_LEVELS; level++) {
+        uint8_t  shift   = level * WHEEL_BITS;
+        uint8_t  current = (wheel_time >> shift) & WHEEL_MASK;
+        uint32_t base    = (level == WHEEL_LEVELS - 1) ? 0 : (wheel_time & ~((1UL << (shift + WHEEL_BITS)) - 1));
+
+        // Only the top level wraps around. A bucket matching the current digit can only be occupied while the wheel sits
+        // exactly on its cascade tick, so it's safe to include in the scan.
+        uint8_t last = (level == WHEEL_LEVELS - 1) ? WHEEL_SIZE - 1 : WHEEL_MASK - current;
+        for (uint8_t offset = 0; offset <= last; offset++) {
+            uint8_t digit = (current + offset) & WHEEL_MASK;
+            if (wheel_heads[level * WHEEL_SIZE + digit] != WHEEL_NONE) {
+                *next = base | ((uint32_t)digit << shift);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void wheel_tick(uint32_t now) {
+    uint32_t tick = wheel_time;
+
+    // Work out the highest level whose digit rolls over on this tick, then cascade from there downwards
+    uint8_t top = 0;
+    while (top < WHEEL_LEVELS - 1 && (tick & ((1UL << ((top + 1) * WHEEL_BITS)) - 1)) == 0) {
+        top++;
+    }
+    for (uint8_t level = top; level > 0; level--) {
+        uint8_t bucket      = level * WHEEL_SIZE + ((tick >> (level * WHEEL_BITS)) & WHEEL_MASK);
+        uint8_t link        = wheel_heads[bucket];
+        wheel_heads[bucket] = WHEEL_NONE;
+        while (link != WHEEL_NONE) {
+            uint8_t next = WHEEL_ENTRY(link)->next;
+            wheel_insert(link);
+            link = next;
+        }
+    }
+
+    // Move everything due on this tick aside, so that anything re-queued by a callback can't be picked up again
+    uint8_t bucket             = tick & WHEEL_MASK;
+    wheel_heads[WHEEL_PENDING] = wheel_heads[bucket];
+    wheel_heads[bucket]        = WHEEL_NONE;
+    for (uint8_t link = wheel_heads[WHEEL_PENDING]; link != WHEEL_NONE; link = WHEEL_ENTRY(link)->next) {
+        WHEEL_ENTRY(link)->bucket = WHEEL_PENDING;
+    }
+    wheel_time = tick + 1;
+
+    uint8_t link;
+    while ((link = wheel_heads[WHEEL_PENDING]) != WHEEL_NONE) {
+        wheel_unlink(link);
+
+        deferred_executor_t *entry      = &WHEEL_ENTRY(link)->executor;
+        deferred_token       curr_token = entry->token;
+        uint32_t             delay_ms   = entry->callback(entry->trigger_time, entry->cb_arg);
+
+        // If the token has changed, then the callback has canceled and re-queued. Skip further processing.
+        if (entry->token != curr_token) {
+            continue;
+        }
+
+        if (delay_ms > 0) {
+            // Repeat with respect to the previous trigger rather than the current time, but not within this pass of
+            // deferred_exec_task(), so that a stall doesn't cause a burst of invocations
+            entry->trigger_time = next_trigger_time(entry->trigger_time, delay_ms, now + 1);
+            wheel_insert(link);
+        } else {
+            wheel_free_entry(link);
+        }
+    }
+}
+
+//------------------------------------
+// Basic API: used by user-mode code, guaranteed to not collide with core deferred execution
+//
 
 deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
-    return defer_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, delay_ms, callback, cb_arg);
+    if (delay_ms == 0 || !callback) {
+        return INVALID_DEFERRED_TOKEN;
+    }
+
+    // Reuse a released slot if there is one, otherwise take the next never-used slot
+    uint8_t link = wheel_free;
+    if (link != WHEEL_NONE) {
+        wheel_free = WHEEL_ENTRY(link)->next;
+    } else if (wheel_high_water < MAX_DEFERRED_EXECUTORS) {
+        link = ++wheel_high_water;
+    } else {
+        return INVALID_DEFERRED_TOKEN;
+    }
+
+    // An empty wheel may have been left behind by the timer, bring it up to date before placing anything in it
+    uint32_t now = timer_read32();
+    if (wheel_count == 0) {
+        wheel_time = now;
+    }
+    wheel_count++;
+
+    deferred_executor_t *entry = &WHEEL_ENTRY(link)->executor;
+    entry->token               = make_token(link - 1);
+    entry->trigger_time        = now + delay_ms;
+    entry->callback            = callback;
+    entry->cb_arg              = cb_arg;
+    wheel_insert(link);
+    return entry->token;
 }
+
 bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
-    return extend_deferred_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, token, delay_ms);
+    uint8_t link = wheel_find(token);
+    if (delay_ms == 0 || link == WHEEL_NONE) {
+        return false;
+    }
+
+    deferred_wheel_entry_t *entry = WHEEL_ENTRY(link);
+    entry->executor.trigger_time  = timer_read32() + delay_ms;
+
+    // If the executor is currently being invoked, it gets re-queued from the new trigger time once its callback returns
+    if (entry->bucket != WHEEL_DETACHED) {
+        wheel_unlink(link);
+        wheel_insert(link);
+    }
+    return true;
 }
+
 bool cancel_deferred_exec(deferred_token token) {
-    return cancel_deferred_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, token);
+    uint8_t link = wheel_find(token);
+    if (link == WHEEL_NONE) {
+        return false;
+    }
+
+    wheel_unlink(link);
+    wheel_free_entry(link);
+    return true;
 }
+
+bool deferred_exec_next_deadline(uint32_t *deadline) {
+    return wheel_next_event(deadline);
+}
+
 void deferred_exec_task(void) {
-    deferred_exec_advanced_task(basic_executors, MAX_DEFERRED_EXECUTORS, &last_deferred_exec_check);
+    uint32_t now = timer_read32();
+
+    // Skip straight over any ticks with nothing to do
+    while (((int32_t)TIMER_DIFF_32(now, wheel_time)) >= 0) {
+        uint32_t next;
+        if (!wheel_next_event(&next) || ((int32_t)TIMER_DIFF_32(next, now)) > 0) {
+            wheel_time = now + 1;
+            break;
+        }
+        wheel_time = next;
+        wheel_tick(now);
+    }
 }
@@ -13,8 +13,13 @@
 
 /**
  * @typedef A token that can be used to cancel or extend an existing deferred execution.
+ * @brief The low byte identifies the executor's slot, the high byte is a rolling serial to catch stale tokens.
+ *
+ * Wider than the number of executors strictly needs: carrying the slot makes lookups O(1) rather than a search of the
+ * table, and the serial stops a token which was cancelled, or has already fired, from acting on an executor which has
+ * since reused its slot. Tables are limited to 255 slots accordingly.
  */
-typedef uint8_t deferred_token;
+typedef uint16_t deferred_token;
 
 /**
  * @def The constant used to denote an invalid deferred execution token.
@@ -60,6 +65,15 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
  */
 bool cancel_deferred_exec(deferred_token token);
 
+/**
+ * Queries when the earliest pending deferred execution is due, for use by power management code.
+ * The returned time is never later than the actual trigger time, but may be earlier -- callers should be prepared to wake up with nothing to do.
+ *
+ * @param deadline[out] the time at which deferred_exec_task() next needs to run -- equivalent time-space as timer_read32()
+ * @return true if a deferred execution is pending, otherwise false and deadline is left untouched
+ */
+bool deferred_exec_next_deadline(uint32_t *deadline);
+
 /**
  * Forward declaration for the main loop in order to execute any deferred executors. Should not be invoked by keyboard/user code.
  */
@@ -85,7 +99,7 @@ typedef struct deferred_executor_t {
  * Configures the supplied deferred executor to be executed after the required number of milliseconds.
  *
  * @param table[in] the custom table used for storage
- * @param table_count[in] the number of available items in the table
+ * @param table_count[in] the number of available items in the table, only the first 255 are used
  * @param delay_ms[in] the number of milliseconds before executing the callback
  * @param callback[in] the executor to invoke
  * @param cb_arg[in] the argument to pass to the executor, may be NULL if unused by the executor
@@ -15,12 +15,15 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "dynamic_keymap.h"
 #include "keymap_introspection.h"
 #include "action.h"
+#include "action_layer.h"
 #include "send_string.h"
 #include "keycodes.h"
 #include "nvm_dynamic_keymap.h"
+#include "timer.h"
 
 #ifdef ENCODER_ENABLE
 #    include "encoder.h"
@@ -36,12 +39,204 @@ uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
 
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+#    ifndef DYNAMIC_KEYMAP_RAM_MIRROR_FLUSH_DELAY
+#        define DYNAMIC_KEYMAP_RAM_MIRROR_FLUSH_DELAY 500
+#    endif
+
+#    define DYNAMIC_KEYMAP_MIRROR_ROWS (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS)
+
+// Keymap lookups are served from RAM, writes are coalesced per layer row and
+// flushed to NVM once the host has gone quiet for DYNAMIC_KEYMAP_RAM_MIRROR_FLUSH_DELAY.
+static uint16_t keymap_mirror[DYNAMIC_KEYMAP_LAYER_COUNT][MATRIX_ROWS][MATRIX_COLS];
+static uint8_t  keymap_mirror_dirty[(DYNAMIC_KEYMAP_MIRROR_ROWS + 7) / 8];
+#    ifdef ENCODER_MAP_ENABLE
+static uint16_t encodermap_mirror[DYNAMIC_KEYMAP_LAYER_COUNT][NUM_ENCODERS][2];
+static bool     encodermap_mirror_dirty = false;
+#    endif // ENCODER_MAP_ENABLE
+static bool     mirror_loaded     = false;
+static bool     mirror_dirty      = false;
+static uint32_t mirror_last_write = 0;
+
+static void dynamic_keymap_mirror_load(void) {
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t column = 0; column < MATRIX_COLS; column++) {
+                keymap_mirror[layer][row][column] = nvm_dynamic_keymap_read_keycode(layer, row, column);
+            }
+        }
+#    ifdef ENCODER_MAP_ENABLE
+        for (uint8_t encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+            encodermap_mirror[layer][encoder][0] = nvm_dynamic_keymap_read_encoder(layer, encoder, true);
+            encodermap_mirror[layer][encoder][1] = nvm_dynamic_keymap_read_encoder(layer, encoder, false);
+        }
+#    endif // ENCODER_MAP_ENABLE
+    }
+    mirror_loaded = true;
+}
+
+static inline void dynamic_keymap_mirror_ensure_loaded(void) {
+    if (!mirror_loaded) {
+        dynamic_keymap_mirror_load();
+    }
+}
+
+static inline void dynamic_keymap_mirror_mark_row(uint16_t mirror_row) {
+    keymap_mirror_dirty[mirror_row / 8] |= (1 << (mirror_row % 8));
+    mirror_dirty      = true;
+    mirror_last_write = timer_read32();
+}
+
+void dynamic_keymap_flush(void) {
+    if (!mirror_dirty) {
+        return;
+    }
+
+    for (uint16_t mirror_row = 0; mirror_row < DYNAMIC_KEYMAP_MIRROR_ROWS; mirror_row++) {
+        if (!(keymap_mirror_dirty[mirror_row / 8] & (1 << (mirror_row % 8)))) {
+            continue;
+        }
+        uint8_t layer = mirror_row / MATRIX_ROWS;
+        uint8_t row   = mirror_row % MATRIX_ROWS;
+        for (uint8_t column = 0; column < MATRIX_COLS; column++) {
+            nvm_dynamic_keymap_update_keycode(layer, row, column, keymap_mirror[layer][row][column]);
+        }
+    }
+    memset(keymap_mirror_dirty, 0, sizeof(keymap_mirror_dirty));
+
+#    ifdef ENCODER_MAP_ENABLE
+    if (encodermap_mirror_dirty) {
+        for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+            for (uint8_t encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+                nvm_dynamic_keymap_update_encoder(layer, encoder, true, encodermap_mirror[layer][encoder][0]);
+                nvm_dynamic_keymap_update_encoder(layer, encoder, false, encodermap_mirror[layer][encoder][1]);
+            }
+        }
+        encodermap_mirror_dirty = false;
+    }
+#    endif // ENCODER_MAP_ENABLE
+
+    mirror_dirty = false;
+}
+
+void dynamic_keymap_task(void) {
+    dynamic_keymap_mirror_ensure_loaded();
+    if (mirror_dirty && timer_elapsed32(mirror_last_write) >= DYNAMIC_KEYMAP_RAM_MIRROR_FLUSH_DELAY) {
+        dynamic_keymap_flush();
+    }
+}
+
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
+    dynamic_keymap_mirror_ensure_loaded();
+    return keymap_mirror[layer][row][column];
+}
+
+void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
+    dynamic_keymap_mirror_ensure_loaded();
+    if (keymap_mirror[layer][row][column] != keycode) {
+        keymap_mirror[layer][row][column] = keycode;
+        dynamic_keymap_mirror_mark_row(layer * MATRIX_ROWS + row);
+    }
+    layer_keycode_cache_invalidate();
+    matrix_ghost_cache_invalidate();
+}
+
+#    ifdef ENCODER_MAP_ENABLE
+uint16_t dynamic_keymap_get_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return KC_NO;
+    dynamic_keymap_mirror_ensure_loaded();
+    return encodermap_mirror[layer][encoder_id][clockwise ? 0 : 1];
+}
+
+void dynamic_keymap_set_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise, uint16_t keycode) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return;
+    dynamic_keymap_mirror_ensure_loaded();
+    if (encodermap_mirror[layer][encoder_id][clockwise ? 0 : 1] != keycode) {
+        encodermap_mirror[layer][encoder_id][clockwise ? 0 : 1] = keycode;
+        encodermap_mirror_dirty                                 = true;
+        mirror_dirty                                            = true;
+        mirror_last_write                                       = timer_read32();
+    }
+}
+#    endif // ENCODER_MAP_ENABLE
+
+void dynamic_keymap_reset(void) {
+    // Erase the keymaps, if necessary.
+    nvm_dynamic_keymap_erase();
+
+    // Reset the mirror to what is in flash.
+    for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (int row = 0; row < MATRIX_ROWS; row++) {
+            for (int column = 0; column < MATRIX_COLS; column++) {
+                keymap_mirror[layer][row][column] = keycode_at_keymap_location_raw(layer, row, column);
+            }
+        }
+#    ifdef ENCODER_MAP_ENABLE
+        for (int encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+            encodermap_mirror[layer][encoder][0] = keycode_at_encodermap_location_raw(layer, encoder, true);
+            encodermap_mirror[layer][encoder][1] = keycode_at_encodermap_location_raw(layer, encoder, false);
+        }
+#    endif // ENCODER_MAP_ENABLE
+    }
+    mirror_loaded = true;
+
+    // The NVM copy may have just been erased, so write everything back immediately.
+    memset(keymap_mirror_dirty, 0xFF, sizeof(keymap_mirror_dirty));
+#    ifdef ENCODER_MAP_ENABLE
+    encodermap_mirror_dirty = true;
+#    endif // ENCODER_MAP_ENABLE
+    mirror_dirty = true;
+    dynamic_keymap_flush();
+    layer_keycode_cache_invalidate();
+    matrix_ghost_cache_invalidate();
+}
+
+void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    dynamic_keymap_mirror_ensure_loaded();
+    // Same big-endian layout as the NVM buffer, anything past the end of the keymaps reads as zero
+    const uint16_t *keycodes = &keymap_mirror[0][0][0];
+    for (uint32_t i = offset; i < (uint32_t)offset + size; i++) {
+        uint32_t index = i / 2;
+        if (index < DYNAMIC_KEYMAP_MIRROR_ROWS * MATRIX_COLS) {
+            *data = (i & 1) ? (keycodes[index] & 0xFF) : (keycodes[index] >> 8);
+        } else {
+            *data = 0x00;
+        }
+        data++;
+    }
+}
+
+void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    dynamic_keymap_mirror_ensure_loaded();
+    uint16_t *keycodes = &keymap_mirror[0][0][0];
+    for (uint32_t i = offset; i < (uint32_t)offset + size; i++) {
+        uint32_t index = i / 2;
+        if (index >= DYNAMIC_KEYMAP_MIRROR_ROWS * MATRIX_COLS) {
+            break;
+        }
+        uint16_t keycode = (i & 1) ? ((keycodes[index] & 0xFF00) | *data) : ((keycodes[index] & 0x00FF) | (*data << 8));
+        if (keycodes[index] != keycode) {
+            keycodes[index] = keycode;
+            dynamic_keymap_mirror_mark_row(index / MATRIX_COLS);
+        }
+        data++;
+    }
+    layer_keycode_cache_invalidate();
+    matrix_ghost_cache_invalidate();
+}
+
+#else // DYNAMIC_KEYMAP_RAM_MIRROR
+
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     return nvm_dynamic_keymap_read_keycode(layer, row, column);
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     nvm_dynamic_keymap_update_keycode(layer, row, column, keycode);
+    layer_keycode_cache_invalidate();
+    matrix_ghost_cache_invalidate();
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -80,7 +275,10 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     nvm_dynamic_keymap_update_buffer(offset, size, data);
+    layer_keycode_cache_invalidate();
+    matrix_ghost_cache_invalidate();
 }
+#endif // DYNAMIC_KEYMAP_RAM_MIRROR
 
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
     if (layer_num < DYNAMIC_KEYMAP_LAYER_COUNT && row < MATRIX_ROWS && column < MATRIX_COLS) {
@@ -45,6 +45,15 @@ void dynamic_keymap_reset(void);
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data);
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
 
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+// With the RAM mirror enabled, keymap and encoder map writes only update RAM.
+// dynamic_keymap_task() writes them back to NVM once no further writes have
+// arrived for DYNAMIC_KEYMAP_RAM_MIRROR_FLUSH_DELAY milliseconds, and
+// dynamic_keymap_flush() forces any pending writes out immediately.
+void dynamic_keymap_task(void);
+void dynamic_keymap_flush(void);
+#endif // DYNAMIC_KEYMAP_RAM_MIRROR
+
 // This overrides the one in quantum/keymap_common.c
 // uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
 
@@ -140,6 +140,15 @@ void eeconfig_init_quantum(void) {
     eeconfig_update_connection_default();
 #endif // CONNECTION_ENABLE
 
+#ifdef ANALOG_MATRIX_ENABLE
+    eeconfig_init_analog_matrix();
+#endif // ANALOG_MATRIX_ENABLE
+
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+    // Invalidated, the matrix measures the settle time again on the next startup
+    eeconfig_update_matrix_io_delay(0);
+#endif // MATRIX_IO_DELAY_CALIBRATION
+
 #if (EECONFIG_KB_DATA_SIZE) > 0
     eeconfig_init_kb_datablock();
 #endif // (EECONFIG_KB_DATA_SIZE) > 0
@@ -321,6 +330,27 @@ void eeconfig_update_connection(const connection_config_t *config) {
 }
 #endif // CONNECTION_ENABLE
 
+#ifdef ANALOG_MATRIX_ENABLE
+bool eeconfig_read_analog_matrix(analog_matrix_eeconfig_t *config) {
+    return nvm_eeconfig_read_analog_matrix(config);
+}
+void eeconfig_update_analog_matrix(const analog_matrix_eeconfig_t *config) {
+    nvm_eeconfig_update_analog_matrix(config);
+}
+void eeconfig_init_analog_matrix(void) {
+    nvm_eeconfig_init_analog_matrix();
+}
+#endif // ANALOG_MATRIX_ENABLE
+
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+uint8_t eeconfig_read_matrix_io_delay(void) {
+    return nvm_eeconfig_read_matrix_io_delay();
+}
+void eeconfig_update_matrix_io_delay(uint8_t val) {
+    nvm_eeconfig_update_matrix_io_delay(val);
+}
+#endif // MATRIX_IO_DELAY_CALIBRATION
+
 bool eeconfig_read_handedness(void) {
     return nvm_eeconfig_read_handedness();
 }
@@ -36,6 +36,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define EECONFIG_USER_DATA_VERSION (EECONFIG_USER_DATA_SIZE)
 #endif
 
+// Size of EEPROM dedicated to analog matrix settings and per-key calibration, including its version
+#ifdef ANALOG_MATRIX_ENABLE
+#    define EECONFIG_ANALOG_MATRIX_DATA_SIZE (8 + (MATRIX_ROWS) * (MATRIX_COLS) * 4)
+#else
+#    define EECONFIG_ANALOG_MATRIX_DATA_SIZE 0
+#endif
+#ifndef EECONFIG_ANALOG_MATRIX_DATA_VERSION
+#    define EECONFIG_ANALOG_MATRIX_DATA_VERSION (EECONFIG_ANALOG_MATRIX_DATA_SIZE)
+#endif
+
+// Size of EEPROM dedicated to the calibrated matrix IO delay
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+#    define EECONFIG_MATRIX_IO_DELAY_DATA_SIZE 1
+#else
+#    define EECONFIG_MATRIX_IO_DELAY_DATA_SIZE 0
+#endif
+
 /* debug bit */
 #define EECONFIG_DEBUG_ENABLE (1 << 0)
 #define EECONFIG_DEBUG_MATRIX (1 << 1)
@@ -137,6 +154,18 @@ void                              eeconfig_read_connection(connection_config_t *
 void                              eeconfig_update_connection(const connection_config_t *config);
 #endif
 
+#ifdef ANALOG_MATRIX_ENABLE
+typedef struct analog_matrix_eeconfig_t analog_matrix_eeconfig_t;
+bool                                    eeconfig_read_analog_matrix(analog_matrix_eeconfig_t *config) __attribute__((nonnull));
+void                                    eeconfig_update_analog_matrix(const analog_matrix_eeconfig_t *config) __attribute__((nonnull));
+void                                    eeconfig_init_analog_matrix(void);
+#endif // ANALOG_MATRIX_ENABLE
+
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+uint8_t eeconfig_read_matrix_io_delay(void);
+void    eeconfig_update_matrix_io_delay(uint8_t val);
+#endif // MATRIX_IO_DELAY_CALIBRATION
+
 bool eeconfig_read_handedness(void);
 void eeconfig_update_handedness(bool val);
 
@@ -0,0 +1,90 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "idle_sleep.h"
+#include "keyboard.h"
+#include "matrix.h"
+#include "timer.h"
+#ifdef DEFERRED_EXEC_ENABLE
+#    include "deferred_exec.h"
+#endif
+#ifdef RGBLIGHT_ENABLE
+#    include "rgblight.h"
+#endif
+#ifdef LED_MATRIX_ENABLE
+#    include "led_matrix.h"
+#endif
+#ifdef RGB_MATRIX_ENABLE
+#    include "rgb_matrix.h"
+#endif
+
+#ifdef SPLIT_KEYBOARD
+#    error Idle sleep is not supported on split keyboards, the transport needs continuous polling
+#endif
+
+__attribute__((weak)) bool idle_sleep_allowed_user(void) {
+    return true;
+}
+
+__attribute__((weak)) bool idle_sleep_allowed_kb(void) {
+    return idle_sleep_allowed_user();
+}
+
+static bool idle_sleep_allowed(void) {
+    if (last_input_activity_elapsed() < MATRIX_IDLE_SLEEP_TIMEOUT) {
+        return false;
+    }
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix_get_row(row)) {
+            return false;
+        }
+    }
+
+    // Animations need the main loop to keep running
+#ifdef RGBLIGHT_ENABLE
+    if (rgblight_is_enabled()) {
+        return false;
+    }
+#endif
+#ifdef LED_MATRIX_ENABLE
+    if (led_matrix_is_enabled()) {
+        return false;
+    }
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    if (rgb_matrix_is_enabled()) {
+        return false;
+    }
+#endif
+
+    return idle_sleep_allowed_kb();
+}
+
+void idle_sleep_task(void) {
+    if (!idle_sleep_allowed()) {
+        return;
+    }
+
+    uint32_t timeout = MATRIX_IDLE_SLEEP_MAX_PERIOD;
+#ifdef DEFERRED_EXEC_ENABLE
+    // Wake up in time for the next deferred execution
+    uint32_t deadline;
+    if (deferred_exec_next_deadline(&deadline)) {
+        int32_t remaining = (int32_t)TIMER_DIFF_32(deadline, timer_read32());
+        if (remaining <= 0) {
+            return;
+        }
+        if ((uint32_t)remaining < timeout) {
+            timeout = remaining;
+        }
+    }
+#endif
+
+    // Clear any stale wakeup before arming, so an edge from here on isn't lost
+    platform_idle_sleep_prepare();
+    if (matrix_idle_arm()) {
+        platform_idle_sleep(timeout);
+    }
+    matrix_idle_disarm();
+}
@@ -0,0 +1,71 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gpio.h"
+
+/*
+    Event-driven idle mode.
+
+    Once the matrix has been idle for MATRIX_IDLE_SLEEP_TIMEOUT milliseconds and
+    no keys are held, the matrix is put into "any key" mode (all outputs driven
+    active, all inputs armed for an edge interrupt) and the main loop blocks
+    until a key edge, USB activity, the next deferred execution is due, or at
+    most MATRIX_IDLE_SLEEP_MAX_PERIOD milliseconds have passed. While blocked,
+    the MCU sits in the RTOS idle thread (WFI) instead of busy-polling
+    matrix_scan().
+
+    Inputs which cannot be armed, because another input already uses the same
+    edge interrupt, are polled instead: the wait is then cut short to at most
+    MATRIX_IDLE_SLEEP_POLL_PERIOD milliseconds.
+*/
+
+#ifndef MATRIX_IDLE_SLEEP_TIMEOUT
+#    define MATRIX_IDLE_SLEEP_TIMEOUT 5000
+#endif
+
+#ifndef MATRIX_IDLE_SLEEP_MAX_PERIOD
+#    define MATRIX_IDLE_SLEEP_MAX_PERIOD 100
+#endif
+
+#ifndef MATRIX_IDLE_SLEEP_POLL_PERIOD
+#    define MATRIX_IDLE_SLEEP_POLL_PERIOD 1
+#endif
+
+/**
+ * \brief Enters idle sleep if the keyboard has been idle long enough. Invoked at the end of keyboard_task().
+ */
+void idle_sleep_task(void);
+
+/**
+ * \brief Allows keyboard-level code to veto idle sleep, for example while animations are running.
+ */
+bool idle_sleep_allowed_kb(void);
+
+/**
+ * \brief Allows user-level code to veto idle sleep, for example while animations are running.
+ */
+bool idle_sleep_allowed_user(void);
+
+/**
+ * \brief Puts the matrix into "any key" mode, arming the inputs for wakeup. Overridable for custom matrices.
+ *
+ * \return false if a key is already pressed, in which case sleep is aborted
+ */
+bool matrix_idle_arm(void);
+
+/**
+ * \brief Disarms the wakeup inputs and restores the matrix to normal scanning.
+ */
+void matrix_idle_disarm(void);
+
+// Platform implementation
+
+void platform_idle_sleep_pin_arm(pin_t pin);
+void platform_idle_sleep_pin_disarm(pin_t pin);
+void platform_idle_sleep_prepare(void);
+void platform_idle_sleep(uint32_t timeout_ms);
+void platform_idle_sleep_wakeup_i(void);
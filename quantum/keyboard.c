@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "keycode_config.h"
 #include "matrix.h"
@@ -32,6 +33,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "task_profiler.h"
+#include "scan_latency.h"
+#include "task_scheduler.h"
 #ifdef BOOTMAGIC_ENABLE
 #    include "bootmagic.h"
 #endif
@@ -65,6 +69,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef HAPTIC_ENABLE
 #    include "haptic.h"
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+#    include "dynamic_keymap.h"
+#endif
 #ifdef AUTO_SHIFT_ENABLE
 #    include "process_auto_shift.h"
 #endif
@@ -149,6 +156,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef CONNECTION_ENABLE
 #    include "connection.h"
 #endif
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    include "idle_sleep.h"
+#endif
+#ifdef RENDER_THREAD_ENABLE
+#    include "render_thread.h"
+#endif
+#ifdef ANALOG_MATRIX_ENABLE
+#    include "analog_matrix.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -157,6 +173,14 @@ uint32_t        last_input_activity_time(void) {
 uint32_t last_input_activity_elapsed(void) {
     return sync_timer_elapsed32(last_input_modification_time);
 }
+uint32_t render_input_activity_elapsed(void) {
+#ifdef RENDER_THREAD_ENABLE
+    // Lighting and displays run in the render thread, which only reads the state published by the main loop
+    return sync_timer_elapsed32(render_thread_state()->last_input_activity);
+#else
+    return last_input_activity_elapsed();
+#endif
+}
 
 static uint32_t last_matrix_modification_time = 0;
 uint32_t        last_matrix_activity_time(void) {
@@ -225,7 +249,23 @@ uint32_t get_matrix_scan_rate(void) {
 #    define matrix_scan_perf_task()
 #endif
 
+// Index of the lowest set bit in a non-zero matrix row
+#if MATRIX_COLS > 16
+#    define MATRIX_ROW_CTZ(bits) __builtin_ctzl(bits)
+#else
+#    define MATRIX_ROW_CTZ(bits) __builtin_ctz(bits)
+#endif
+
 #ifdef MATRIX_HAS_GHOST
+/* Ghost detection state, updated incrementally as rows change: the real (keymapped) keys of
+   each row, the real keys currently down on each row, and on how many rows each column has
+   a real key down, summarised as the columns down on two or more rows. */
+static matrix_row_t ghost_real_keys[MATRIX_ROWS];
+static matrix_row_t ghost_rows[MATRIX_ROWS];
+static uint8_t      ghost_col_counts[MATRIX_COLS];
+static matrix_row_t ghost_cols_multi;
+static bool         ghost_real_keys_valid = false;
+
 static matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata) {
     matrix_row_t out = 0;
     for (uint8_t col = 0; col < MATRIX_COLS; col++) {
@@ -243,24 +283,66 @@ static inline bool popcount_more_than_one(matrix_row_t rowdata) {
     return rowdata;
 }
 
+void matrix_ghost_cache_invalidate(void) {
+    ghost_real_keys_valid = false;
+}
+
+static void ghost_track_row(uint8_t row, matrix_row_t rowdata) {
+    rowdata &= ghost_real_keys[row];
+    for (matrix_row_t changes = ghost_rows[row] ^ rowdata; changes; changes &= changes - 1) {
+        const uint8_t      col   = MATRIX_ROW_CTZ(changes);
+        const matrix_row_t mask  = MATRIX_ROW_SHIFTER << col;
+        const uint8_t      count = (rowdata & mask) ? ++ghost_col_counts[col] : --ghost_col_counts[col];
+
+        ghost_cols_multi = count > 1 ? (ghost_cols_multi | mask) : (ghost_cols_multi & ~mask);
+    }
+    ghost_rows[row] = rowdata;
+}
+
+/* Brings the ghost detection state in line with the current matrix, only rows that differ are visited */
+static void ghost_sync(void) {
+    if (!ghost_real_keys_valid) {
+        // The keymap changed, start over
+        memset(ghost_rows, 0, sizeof(ghost_rows));
+        memset(ghost_col_counts, 0, sizeof(ghost_col_counts));
+        ghost_cols_multi = 0;
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            ghost_real_keys[row] = get_real_keys(row, (matrix_row_t)~0);
+        }
+        ghost_real_keys_valid = true;
+    }
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        const matrix_row_t rowdata = matrix_get_row(row);
+        if ((rowdata & ghost_real_keys[row]) != ghost_rows[row]) {
+            ghost_track_row(row, rowdata);
+        }
+    }
+}
+
+/* Only valid once ghost_sync() has run for the current matrix state */
 static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     /* No ghost exists when less than 2 keys are down on the row.
     If there are "active" blanks in the matrix, the key can't be pressed by the user,
     there is no doubt as to which keys are really being pressed.
     The ghosts will be ignored, they are KC_NO.   */
-    rowdata = get_real_keys(row, rowdata);
+    rowdata &= ghost_real_keys[row];
     if ((popcount_more_than_one(rowdata)) == 0) {
         return false;
     }
     /* Ghost occurs when the row shares a column line with other row,
     and two columns are read on each row. Blanks in the matrix don't matter,
     so they are filtered out.
-    If there are two or more real keys pressed and they match columns with
-    at least two of another row's real keys, the row will be ignored. Keep in mind,
-    we are checking one row at a time, not all of them at once.
+    This row's own keys are already counted, so the columns it shares with any
+    other row are those down on at least two rows. Unless there are two of them,
+    no other row can match two columns, and no row has to be visited.
     */
+    const matrix_row_t shared = rowdata & ghost_cols_multi;
+    if ((popcount_more_than_one(shared)) == 0) {
+        return false;
+    }
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)) {
+        if (i != row && popcount_more_than_one(ghost_rows[i] & shared)) {
             return true;
         }
     }
@@ -273,6 +355,8 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     return false;
 }
 
+static inline void ghost_sync(void) {}
+
 #endif
 
 /** \brief matrix_setup
@@ -419,6 +503,10 @@ __attribute__((weak)) void housekeeping_task_user(void) {}
  * Invokes hooks for executing code after QMK is done after each loop iteration.
  */
 void housekeeping_task(void) {
+#ifdef ANALOG_MATRIX_ENABLE
+    // Calibration is written back here rather than during the scan, so an EEPROM write never delays one
+    analog_matrix_task();
+#endif
     housekeeping_task_modules();
     housekeeping_task_kb();
     housekeeping_task_user();
@@ -542,6 +630,10 @@ void keyboard_init(void) {
     haptic_init();
 #endif
 
+#ifdef TASK_SCHEDULER_ENABLE
+    task_scheduler_init();
+#endif
+
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
     debug_enable = true;
 #endif
@@ -590,12 +682,19 @@ static bool matrix_task(void) {
     }
 
     static matrix_row_t matrix_previous[MATRIX_ROWS];
+    matrix_row_t        matrix_changes[MATRIX_ROWS];
+    matrix_row_t        any_changes = 0;
 
+    SCAN_LATENCY_SCAN_BEGIN();
     matrix_scan();
-    bool matrix_changed = false;
-    for (uint8_t row = 0; row < MATRIX_ROWS && !matrix_changed; row++) {
-        matrix_changed |= matrix_previous[row] ^ matrix_get_row(row);
+    // All changes found by this scan share its timestamp, regardless of how long processing the earlier ones takes
+    const uint16_t scan_time = timer_read();
+    // Diff the whole matrix in a single branch-free pass, the changed bits are kept for event extraction below
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_changes[row] = matrix_previous[row] ^ matrix_get_row(row);
+        any_changes |= matrix_changes[row];
     }
+    const bool matrix_changed = any_changes != 0;
 
     matrix_scan_perf_task();
 
@@ -605,36 +704,52 @@ static bool matrix_task(void) {
         return matrix_changed;
     }
 
+    SCAN_LATENCY_MATRIX_CHANGED();
+
     if (debug_config.matrix) {
         matrix_print();
     }
 
     const bool process_keypress = should_process_keypress();
 
-    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-        const matrix_row_t current_row = matrix_get_row(row);
-        const matrix_row_t row_changes = current_row ^ matrix_previous[row];
+    ghost_sync();
 
-        if (!row_changes || has_ghost_in_row(row, current_row)) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (!matrix_changes[row]) {
             continue;
         }
 
-        matrix_row_t col_mask = 1;
-        for (uint8_t col = 0; col < MATRIX_COLS; col++, col_mask <<= 1) {
-            if (row_changes & col_mask) {
-                const bool key_pressed = current_row & col_mask;
+        const matrix_row_t current_row = matrix_previous[row] ^ matrix_changes[row];
+        if (has_ghost_in_row(row, current_row)) {
+            matrix_changes[row] = 0;
+            continue;
+        }
 
-                if (process_keypress) {
-                    action_exec(MAKE_KEYEVENT(row, col, key_pressed));
-                }
+        // Only visit the changed columns, lowest first
+        for (matrix_row_t row_changes = matrix_changes[row]; row_changes; row_changes &= row_changes - 1) {
+            const uint8_t col         = MATRIX_ROW_CTZ(row_changes);
+            const bool    key_pressed = current_row & (MATRIX_ROW_SHIFTER << col);
 
-                switch_events(row, col, key_pressed);
+            if (process_keypress) {
+                action_exec(MAKE_KEYEVENT_AT(row, col, key_pressed, scan_time));
             }
         }
 
         matrix_previous[row] = current_row;
     }
 
+#if defined(LED_MATRIX_ENABLE) || defined(RGB_MATRIX_ENABLE)
+    // Reactive effects are fed in one batch, once every key event of this scan has been dispatched
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (matrix_row_t row_changes = matrix_changes[row]; row_changes; row_changes &= row_changes - 1) {
+            const uint8_t col = MATRIX_ROW_CTZ(row_changes);
+            switch_events(row, col, matrix_previous[row] & (MATRIX_ROW_SHIFTER << col));
+        }
+    }
+#endif
+
+    SCAN_LATENCY_SCAN_END();
+
     return matrix_changed;
 }
 
@@ -717,99 +832,219 @@ void quantum_task(void) {
 #endif
 }
 
+#ifdef RENDER_THREAD_ENABLE
+// The task profiler rings belong to the main thread, so stages run by the render thread are not profiled
+#    define RENDER_PROFILER_BEGIN(stage)
+#    define RENDER_PROFILER_END(stage)
+#else
+#    define RENDER_PROFILER_BEGIN(stage) TASK_PROFILER_BEGIN(stage)
+#    define RENDER_PROFILER_END(stage) TASK_PROFILER_END(stage)
+#endif
+
+/** \brief Lighting tasks
+ *
+ * Run from keyboard_task(), or from the render thread when RENDER_THREAD_ENABLE is set.
+ */
+static void lighting_task(void) {
+#if defined(RGBLIGHT_ENABLE)
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_RGBLIGHT)) {
+        RENDER_PROFILER_BEGIN(TASK_PROFILER_RGBLIGHT_TASK);
+        rgblight_task();
+        RENDER_PROFILER_END(TASK_PROFILER_RGBLIGHT_TASK);
+    }
+#endif
+
+#ifdef LED_MATRIX_ENABLE
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_LED_MATRIX)) {
+        RENDER_PROFILER_BEGIN(TASK_PROFILER_LED_MATRIX_TASK);
+        led_matrix_task();
+        RENDER_PROFILER_END(TASK_PROFILER_LED_MATRIX_TASK);
+    }
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_RGB_MATRIX)) {
+        RENDER_PROFILER_BEGIN(TASK_PROFILER_RGB_MATRIX_TASK);
+        rgb_matrix_task();
+        RENDER_PROFILER_END(TASK_PROFILER_RGB_MATRIX_TASK);
+    }
+#endif
+
+#if defined(BACKLIGHT_ENABLE)
+#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_BACKLIGHT)) {
+        RENDER_PROFILER_BEGIN(TASK_PROFILER_BACKLIGHT_TASK);
+        backlight_task();
+        RENDER_PROFILER_END(TASK_PROFILER_BACKLIGHT_TASK);
+    }
+#    endif
+#endif
+}
+
+/** \brief Display tasks
+ *
+ * Run from keyboard_task(), or from the render thread when RENDER_THREAD_ENABLE is set.
+ */
+static void display_task(bool activity_has_occurred) {
+#ifdef OLED_ENABLE
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_OLED)) {
+        RENDER_PROFILER_BEGIN(TASK_PROFILER_OLED_TASK);
+        oled_task();
+        RENDER_PROFILER_END(TASK_PROFILER_OLED_TASK);
+    }
+#    if OLED_TIMEOUT > 0
+    // Wake up oled if user is using those fabulous keys or spinning those encoders!
+    if (activity_has_occurred) oled_on();
+#    endif
+#endif
+
+#ifdef ST7565_ENABLE
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_ST7565)) {
+        RENDER_PROFILER_BEGIN(TASK_PROFILER_ST7565_TASK);
+        st7565_task();
+        RENDER_PROFILER_END(TASK_PROFILER_ST7565_TASK);
+    }
+#    if ST7565_TIMEOUT > 0
+    // Wake up display if user is using those fabulous keys or spinning those encoders!
+    if (activity_has_occurred) st7565_on();
+#    endif
+#endif
+}
+
+#ifdef RENDER_THREAD_ENABLE
+void keyboard_render_task(bool activity_has_occurred) {
+    lighting_task();
+    display_task(activity_has_occurred);
+}
+#endif
+
 /** \brief Main task that is repeatedly called as fast as possible. */
 void keyboard_task(void) {
     __attribute__((unused)) bool activity_has_occurred = false;
+    TASK_PROFILER_BEGIN(TASK_PROFILER_KEYBOARD_TASK);
+
+    TASK_PROFILER_BEGIN(TASK_PROFILER_MATRIX_TASK);
     if (matrix_task()) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
+    TASK_PROFILER_END(TASK_PROFILER_MATRIX_TASK);
 
+    TASK_PROFILER_BEGIN(TASK_PROFILER_QUANTUM_TASK);
     quantum_task();
+    TASK_PROFILER_END(TASK_PROFILER_QUANTUM_TASK);
 
-#if defined(SPLIT_WATCHDOG_ENABLE)
-    split_watchdog_task();
-#endif
-
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
+#ifdef TASK_SCHEDULER_ENABLE
+    // Cosmetic tasks only get time on iterations without pending key events
+    task_scheduler_begin_iteration(activity_has_occurred);
 #endif
 
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+#if defined(SPLIT_WATCHDOG_ENABLE)
+    TASK_PROFILER_BEGIN(TASK_PROFILER_SPLIT_WATCHDOG_TASK);
+    split_watchdog_task();
+    TASK_PROFILER_END(TASK_PROFILER_SPLIT_WATCHDOG_TASK);
 #endif
 
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
-#    endif
+#ifndef RENDER_THREAD_ENABLE
+    lighting_task();
 #endif
 
 #ifdef ENCODER_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_ENCODER_TASK);
     if (encoder_task()) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
+    TASK_PROFILER_END(TASK_PROFILER_ENCODER_TASK);
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_POINTING_DEVICE_TASK);
     if (pointing_device_task()) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
+    TASK_PROFILER_END(TASK_PROFILER_POINTING_DEVICE_TASK);
 #endif
 
-#ifdef OLED_ENABLE
-    oled_task();
-#    if OLED_TIMEOUT > 0
-    // Wake up oled if user is using those fabulous keys or spinning those encoders!
-    if (activity_has_occurred) oled_on();
-#    endif
-#endif
-
-#ifdef ST7565_ENABLE
-    st7565_task();
-#    if ST7565_TIMEOUT > 0
-    // Wake up display if user is using those fabulous keys or spinning those encoders!
-    if (activity_has_occurred) st7565_on();
-#    endif
+#ifndef RENDER_THREAD_ENABLE
+    display_task(activity_has_occurred);
 #endif
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
+    TASK_PROFILER_BEGIN(TASK_PROFILER_MOUSEKEY_TASK);
     mousekey_task();
+    TASK_PROFILER_END(TASK_PROFILER_MOUSEKEY_TASK);
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_PS2_MOUSE_TASK);
     ps2_mouse_task();
+    TASK_PROFILER_END(TASK_PROFILER_PS2_MOUSE_TASK);
 #endif
 
 #ifdef MIDI_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_MIDI_TASK);
     midi_task();
+    TASK_PROFILER_END(TASK_PROFILER_MIDI_TASK);
 #endif
 
 #ifdef JOYSTICK_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_JOYSTICK_TASK);
     joystick_task();
+    TASK_PROFILER_END(TASK_PROFILER_JOYSTICK_TASK);
 #endif
 
 #ifdef BATTERY_DRIVER
-    battery_task();
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_BATTERY)) {
+        TASK_PROFILER_BEGIN(TASK_PROFILER_BATTERY_TASK);
+        battery_task();
+        TASK_PROFILER_END(TASK_PROFILER_BATTERY_TASK);
+    }
 #endif
 
 #ifdef BLUETOOTH_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_BLUETOOTH_TASK);
     bluetooth_task();
+    TASK_PROFILER_END(TASK_PROFILER_BLUETOOTH_TASK);
 #endif
 
 #ifdef HAPTIC_ENABLE
-    haptic_task();
+    if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_HAPTIC)) {
+        TASK_PROFILER_BEGIN(TASK_PROFILER_HAPTIC_TASK);
+        haptic_task();
+        TASK_PROFILER_END(TASK_PROFILER_HAPTIC_TASK);
+    }
+#endif
+
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_MIRROR)
+    dynamic_keymap_task();
 #endif
 
+    TASK_PROFILER_BEGIN(TASK_PROFILER_LED_TASK);
     led_task();
+    TASK_PROFILER_END(TASK_PROFILER_LED_TASK);
 
 #ifdef OS_DETECTION_ENABLE
+    TASK_PROFILER_BEGIN(TASK_PROFILER_OS_DETECTION_TASK);
     os_detection_task();
+    TASK_PROFILER_END(TASK_PROFILER_OS_DETECTION_TASK);
+#endif
+
+    TASK_PROFILER_END(TASK_PROFILER_KEYBOARD_TASK);
+
+#ifdef TASK_PROFILER_ENABLE
+    task_profiler_task();
+#endif
+
+#ifdef SCAN_LATENCY_ENABLE
+    scan_latency_task();
+#endif
+
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+    // Nothing else to do, block until a key edge or another wakeup source
+    if (!activity_has_occurred) {
+        idle_sleep_task();
+    }
 #endif
 }
@@ -81,6 +81,11 @@ static inline bool IS_DIPSWITCHEVENT(const keyevent_t event) {
  */
 #define MAKE_KEYEVENT(row_num, col_num, press) MAKE_EVENT((row_num), (col_num), (press), KEY_EVENT)
 
+/**
+ * @brief Constructs a key event for a pressed or released key, timestamped at the given time rather than now.
+ */
+#define MAKE_KEYEVENT_AT(row_num, col_num, press, event_time) ((keyevent_t){.key = MAKE_KEYPOS((row_num), (col_num)), .pressed = (press), .time = (event_time), .type = KEY_EVENT})
+
 /**
  * @brief Constructs a combo event.
  */
@@ -119,12 +124,20 @@ void keyboard_pre_init_user(void);
 void keyboard_post_init_kb(void);
 void keyboard_post_init_user(void);
 
+#ifdef MATRIX_HAS_GHOST
+/* discard the cached real keys used for ghost detection, must be called whenever the base layer changes at runtime */
+void matrix_ghost_cache_invalidate(void);
+#else
+#    define matrix_ghost_cache_invalidate()
+#endif
+
 void housekeeping_task(void);      // To be executed by the main loop in each backend TMK protocol
 void housekeeping_task_kb(void);   // To be overridden by keyboard-level code
 void housekeeping_task_user(void); // To be overridden by user/keymap-level code
 
-uint32_t last_input_activity_time(void);    // Timestamp of the last matrix or encoder or pointing device activity
-uint32_t last_input_activity_elapsed(void); // Number of milliseconds since the last matrix or encoder or pointing device activity
+uint32_t last_input_activity_time(void);      // Timestamp of the last matrix or encoder or pointing device activity
+uint32_t last_input_activity_elapsed(void);   // Number of milliseconds since the last matrix or encoder or pointing device activity
+uint32_t render_input_activity_elapsed(void); // As above, for lighting and display code: from the render thread's snapshot when RENDER_THREAD_ENABLE is set
 
 uint32_t last_matrix_activity_time(void);    // Timestamp of the last matrix activity
 uint32_t last_matrix_activity_elapsed(void); // Number of milliseconds since the last matrix activity
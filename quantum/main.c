@@ -15,6 +15,11 @@
  */
 
 #include "keyboard.h"
+#include "task_profiler.h"
+#include "task_scheduler.h"
+#ifdef RENDER_THREAD_ENABLE
+#    include "render_thread.h"
+#endif
 
 void platform_setup(void);
 
@@ -43,6 +48,9 @@ int main(void) {
     protocol_pre_init();
     keyboard_init();
     protocol_post_init();
+#ifdef RENDER_THREAD_ENABLE
+    render_thread_init();
+#endif
 
     /* Main loop */
     while (true) {
@@ -52,26 +60,44 @@ int main(void) {
 
 #ifdef RAW_ENABLE
         void raw_hid_task(void);
+        TASK_PROFILER_BEGIN(TASK_PROFILER_RAW_HID_TASK);
         raw_hid_task();
+        TASK_PROFILER_END(TASK_PROFILER_RAW_HID_TASK);
 #endif
 
 #ifdef CONSOLE_ENABLE
         void console_task(void);
+        TASK_PROFILER_BEGIN(TASK_PROFILER_CONSOLE_TASK);
         console_task();
+        TASK_PROFILER_END(TASK_PROFILER_CONSOLE_TASK);
 #endif
 
-#ifdef QUANTUM_PAINTER_ENABLE
+#if defined(QUANTUM_PAINTER_ENABLE) && !defined(RENDER_THREAD_ENABLE)
         // Run Quantum Painter task
         void qp_internal_task(void);
-        qp_internal_task();
+        if (TASK_SCHEDULER_SHOULD_RUN(TASK_SCHEDULER_QUANTUM_PAINTER)) {
+            TASK_PROFILER_BEGIN(TASK_PROFILER_QUANTUM_PAINTER_TASK);
+            qp_internal_task();
+            TASK_PROFILER_END(TASK_PROFILER_QUANTUM_PAINTER_TASK);
+        }
 #endif
 
 #ifdef DEFERRED_EXEC_ENABLE
         // Run deferred executions
         void deferred_exec_task(void);
+        TASK_PROFILER_BEGIN(TASK_PROFILER_DEFERRED_EXEC_TASK);
         deferred_exec_task();
+        TASK_PROFILER_END(TASK_PROFILER_DEFERRED_EXEC_TASK);
 #endif // DEFERRED_EXEC_ENABLE
 
+        TASK_PROFILER_BEGIN(TASK_PROFILER_HOUSEKEEPING_TASK);
         housekeeping_task();
+        TASK_PROFILER_END(TASK_PROFILER_HOUSEKEEPING_TASK);
+
+#ifdef RENDER_THREAD_ENABLE
+        // Let the render thread take its turn
+        render_thread_publish();
+        render_thread_main_loop_wait();
+#endif
     }
 }
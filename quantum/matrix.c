@@ -21,6 +21,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "atomic_util.h"
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    include "idle_sleep.h"
+#endif
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+#    include "eeconfig.h"
+#    include "wait.h"
+#endif
 
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
@@ -51,6 +58,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define MATRIX_INPUT_PRESSED_STATE 0
 #endif
 
+#if defined(MATRIX_PORT_SCAN) && (defined(DIRECT_PINS) || !defined(MATRIX_ROW_PINS) || !defined(MATRIX_COL_PINS) || (DIODE_DIRECTION != COL2ROW))
+#    error MATRIX_PORT_SCAN requires a COL2ROW matrix defined by MATRIX_ROW_PINS and MATRIX_COL_PINS
+#endif
+
+#if defined(MATRIX_IO_DELAY_CALIBRATION) && (defined(DIRECT_PINS) || !defined(MATRIX_ROW_PINS) || !defined(MATRIX_COL_PINS) || (MATRIX_INPUT_PRESSED_STATE != 0))
+#    error MATRIX_IO_DELAY_CALIBRATION requires a matrix defined by MATRIX_ROW_PINS and MATRIX_COL_PINS with pull-up inputs
+#endif
+
 #ifdef DIRECT_PINS
 static SPLIT_MUTABLE pin_t direct_pins[ROWS_PER_HAND][MATRIX_COLS] = DIRECT_PINS;
 #elif (DIODE_DIRECTION == ROW2COL) || (DIODE_DIRECTION == COL2ROW)
@@ -163,6 +178,72 @@ static void unselect_rows(void) {
     }
 }
 
+#            ifdef MATRIX_PORT_SCAN
+#                ifndef gpio_read_port
+#                    error MATRIX_PORT_SCAN is not supported on this platform
+#                endif
+
+// A run of consecutive columns wired to consecutive bits of the same port
+typedef struct port_scan_run_t {
+    uint8_t port;  // index into port_scan_pins
+    uint8_t pad;   // first port bit of the run
+    uint8_t col;   // first column of the run
+    uint8_t width; // number of bits in the run
+} port_scan_run_t;
+
+static pin_t           port_scan_pins[MATRIX_COLS]; // one col pin per distinct port, used to address the port
+static uint8_t         port_scan_port_count = 0;
+static port_scan_run_t port_scan_runs[MATRIX_COLS];
+static uint8_t         port_scan_run_count = 0;
+
+static void port_scan_init(void) {
+    port_scan_port_count = 0;
+    port_scan_run_count  = 0;
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        pin_t pin = col_pins[col];
+        if (pin == NO_PIN) {
+            continue;
+        }
+
+        uint8_t port = 0;
+        while (port < port_scan_port_count && gpio_pin_port(port_scan_pins[port]) != gpio_pin_port(pin)) {
+            port++;
+        }
+        if (port == port_scan_port_count) {
+            port_scan_pins[port_scan_port_count++] = pin;
+        }
+
+        // Extend the previous run if this column carries on from it, otherwise start a new one
+        uint8_t          pad  = gpio_pin_pad(pin);
+        port_scan_run_t *last = port_scan_run_count ? &port_scan_runs[port_scan_run_count - 1] : NULL;
+        if (last && last->port == port && last->col + last->width == col && last->pad + last->width == pad) {
+            last->width++;
+        } else {
+            port_scan_runs[port_scan_run_count++] = (port_scan_run_t){.port = port, .pad = pad, .col = col, .width = 1};
+        }
+    }
+}
+
+static matrix_row_t port_scan_read_cols(void) {
+    uint32_t port_values[MATRIX_COLS];
+    for (uint8_t i = 0; i < port_scan_port_count; i++) {
+        port_values[i] = gpio_read_port(port_scan_pins[i]);
+#                if MATRIX_INPUT_PRESSED_STATE == 0
+        port_values[i] = ~port_values[i];
+#                endif
+    }
+
+    matrix_row_t row_value = 0;
+    for (uint8_t i = 0; i < port_scan_run_count; i++) {
+        const port_scan_run_t *run  = &port_scan_runs[i];
+        uint32_t               mask = ((uint32_t)2 << (run->width - 1)) - 1;
+        row_value |= (matrix_row_t)((port_values[run->port] >> run->pad) & mask) << run->col;
+    }
+    return row_value;
+}
+#            endif // MATRIX_PORT_SCAN
+
 __attribute__((weak)) void matrix_init_pins(void) {
     unselect_rows();
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
@@ -181,6 +262,10 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_PORT_SCAN
+    // Read each col port once
+    current_row_value = port_scan_read_cols();
+#            else
     // For each col...
     matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
@@ -189,6 +274,7 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
         // Populate the matrix row with the state of the col pin
         current_row_value |= pin_state ? 0 : row_shifter;
     }
+#            endif
 
     // Unselect row
     unselect_row(current_row);
@@ -270,6 +356,165 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+#    ifndef MATRIX_IO_DELAY
+#        define MATRIX_IO_DELAY 30
+#    endif
+#    ifndef MATRIX_IO_DELAY_CALIBRATION_ROUNDS
+#        define MATRIX_IO_DELAY_CALIBRATION_ROUNDS 4
+#    endif
+#    ifndef MATRIX_IO_DELAY_CALIBRATION_MARGIN
+#        define MATRIX_IO_DELAY_CALIBRATION_MARGIN 2
+#    endif
+
+// The rise time is measured with interrupts disabled, so waits have to be busy loops. On ChibiOS wait_us() may
+// instead sleep the thread or start a timer which needs interrupts, so the realtime counter is polled directly.
+#    if defined(PROTOCOL_CHIBIOS)
+#        if PORT_SUPPORTS_RT == FALSE
+#            error MATRIX_IO_DELAY_CALIBRATION requires a ChibiOS port with a realtime counter
+#        endif
+#        define calibration_wait_us(us) chSysPolledDelayX(US2RTC(REALTIME_COUNTER_CLOCK, us))
+#    else
+#        define calibration_wait_us(us) wait_us(us)
+#    endif
+
+#    if (DIODE_DIRECTION == COL2ROW)
+#        define CALIBRATION_INPUT_COUNT MATRIX_COLS
+#        define calibration_input_pins col_pins
+#    else
+#        define CALIBRATION_INPUT_COUNT ROWS_PER_HAND
+#        define calibration_input_pins row_pins
+#    endif
+
+// Pulls an input line low, releases it, and counts the microseconds its pull-up takes to bring it back high.
+// Returns more than MATRIX_IO_DELAY if the line did not settle in time.
+static uint8_t measure_input_rise_time(pin_t pin) {
+    uint8_t elapsed = 0;
+    ATOMIC_BLOCK_FORCEON {
+        gpio_set_pin_output(pin);
+        gpio_write_pin_low(pin);
+        calibration_wait_us(1);
+        gpio_set_pin_input_high(pin);
+        while (!gpio_read_pin(pin) && elapsed <= MATRIX_IO_DELAY) {
+            calibration_wait_us(1);
+            elapsed++;
+        }
+    }
+    return elapsed;
+}
+
+bool matrix_io_delay_calibrate(void) {
+    uint8_t rise_time = 0;
+    for (uint8_t round = 0; round < MATRIX_IO_DELAY_CALIBRATION_ROUNDS; round++) {
+        for (uint8_t x = 0; x < CALIBRATION_INPUT_COUNT; x++) {
+            pin_t pin = calibration_input_pins[x];
+            if (pin != NO_PIN) {
+                rise_time = MAX(rise_time, measure_input_rise_time(pin));
+            }
+        }
+    }
+
+    if (rise_time > MATRIX_IO_DELAY) {
+        // A line that never settles points at a hardware fault, stay on the safe default and measure again next time
+        matrix_io_delay_set(MATRIX_IO_DELAY);
+        return false;
+    }
+
+    // Every poll above takes a little longer than a microsecond, so this is already rounded up, the margin covers drift
+    uint16_t delay = MIN(rise_time + rise_time / 2 + MATRIX_IO_DELAY_CALIBRATION_MARGIN, MATRIX_IO_DELAY);
+    matrix_io_delay_set(delay);
+    if (eeconfig_is_enabled()) {
+        eeconfig_update_matrix_io_delay(delay);
+    }
+    return true;
+}
+
+static void matrix_io_delay_init(void) {
+    // Before the EEPROM is first initialized it holds no valid measurement
+    uint8_t delay = eeconfig_is_enabled() ? eeconfig_read_matrix_io_delay() : 0;
+    if (delay > 0 && delay <= MATRIX_IO_DELAY) {
+        matrix_io_delay_set(delay);
+    } else {
+        matrix_io_delay_calibrate();
+    }
+}
+#endif // MATRIX_IO_DELAY_CALIBRATION
+
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    ifdef DIRECT_PINS
+
+__attribute__((weak)) bool matrix_idle_arm(void) {
+    bool pressed = false;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            pin_t pin = direct_pins[row][col];
+            if (pin != NO_PIN) {
+                platform_idle_sleep_pin_arm(pin);
+                pressed |= readMatrixPin(pin) == 0;
+            }
+        }
+    }
+    return !pressed;
+}
+
+__attribute__((weak)) void matrix_idle_disarm(void) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            pin_t pin = direct_pins[row][col];
+            if (pin != NO_PIN) {
+                platform_idle_sleep_pin_disarm(pin);
+            }
+        }
+    }
+}
+
+#    elif defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
+#        if (DIODE_DIRECTION == COL2ROW)
+#            define IDLE_OUTPUT_COUNT ROWS_PER_HAND
+#            define IDLE_INPUT_COUNT MATRIX_COLS
+#            define idle_input_pins col_pins
+#            define idle_select_output select_row
+#            define idle_unselect_outputs unselect_rows
+#        else
+#            define IDLE_OUTPUT_COUNT MATRIX_COLS
+#            define IDLE_INPUT_COUNT ROWS_PER_HAND
+#            define idle_input_pins row_pins
+#            define idle_select_output select_col
+#            define idle_unselect_outputs unselect_cols
+#        endif
+
+__attribute__((weak)) bool matrix_idle_arm(void) {
+    // Drive every output active, so that any keypress pulls its input line
+    for (uint8_t x = 0; x < IDLE_OUTPUT_COUNT; x++) {
+        idle_select_output(x);
+    }
+    matrix_output_select_delay();
+
+    bool pressed = false;
+    for (uint8_t x = 0; x < IDLE_INPUT_COUNT; x++) {
+        pin_t pin = idle_input_pins[x];
+        if (pin != NO_PIN) {
+            platform_idle_sleep_pin_arm(pin);
+            pressed |= readMatrixPin(pin) == 0;
+        }
+    }
+    return !pressed;
+}
+
+__attribute__((weak)) void matrix_idle_disarm(void) {
+    for (uint8_t x = 0; x < IDLE_INPUT_COUNT; x++) {
+        pin_t pin = idle_input_pins[x];
+        if (pin != NO_PIN) {
+            platform_idle_sleep_pin_disarm(pin);
+        }
+    }
+    idle_unselect_outputs();
+    matrix_output_unselect_delay(0, true);
+}
+
+#    endif
+#endif // MATRIX_IDLE_SLEEP_ENABLE
+
 void matrix_init(void) {
 #ifdef SPLIT_KEYBOARD
     // Set pinout for right half if pinout for that half is defined
@@ -302,6 +547,12 @@ void matrix_init(void) {
 
     // initialize key pins
     matrix_init_pins();
+#ifdef MATRIX_PORT_SCAN
+    port_scan_init();
+#endif
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+    matrix_io_delay_init();
+#endif
 
     // initialize matrix state: all keys off
     memset(matrix, 0, sizeof(matrix));
@@ -65,6 +65,13 @@ void matrix_output_unselect_delay(uint8_t line, bool key_pressed);
 /* only for backwards compatibility. delay between changing matrix pin state and reading values */
 void matrix_io_delay(void);
 
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+/* measure how long the input lines take to settle, and use that as the delay instead of MATRIX_IO_DELAY */
+bool    matrix_io_delay_calibrate(void);
+uint8_t matrix_io_delay_get(void);
+void    matrix_io_delay_set(uint8_t delay);
+#endif
+
 /* power control */
 void matrix_power_up(void);
 void matrix_power_down(void);
@@ -122,9 +122,25 @@ bool matrix_post_scan(void) {
 }
 #endif
 
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+static uint8_t matrix_io_delay_us = MATRIX_IO_DELAY;
+
+uint8_t matrix_io_delay_get(void) {
+    return matrix_io_delay_us;
+}
+
+void matrix_io_delay_set(uint8_t delay) {
+    matrix_io_delay_us = (delay > 0 && delay <= MATRIX_IO_DELAY) ? delay : MATRIX_IO_DELAY;
+}
+#endif
+
 /* `matrix_io_delay ()` exists for backwards compatibility. From now on, use matrix_output_unselect_delay(). */
 __attribute__((weak)) void matrix_io_delay(void) {
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+    wait_us(matrix_io_delay_us);
+#else
     wait_us(MATRIX_IO_DELAY);
+#endif
 }
 __attribute__((weak)) void matrix_output_select_delay(void) {
     waitInputPinDelay();
@@ -45,6 +45,10 @@
 #    include "connection.h"
 #endif
 
+#ifdef ANALOG_MATRIX_ENABLE
+#    include "analog_matrix.h"
+#endif
+
 void nvm_eeconfig_erase(void) {
 #ifdef EEPROM_DRIVER
     eeprom_driver_format(false);
@@ -209,6 +213,35 @@ void nvm_eeconfig_update_connection(const connection_config_t *config) {
 }
 #endif // CONNECTION_ENABLE
 
+#ifdef ANALOG_MATRIX_ENABLE
+STATIC_ASSERT(sizeof(uint32_t) + sizeof(analog_matrix_eeconfig_t) == EECONFIG_ANALOG_MATRIX_DATA_SIZE, "EECONFIG_ANALOG_MATRIX_DATA_SIZE does not match analog_matrix_eeconfig_t");
+
+bool nvm_eeconfig_read_analog_matrix(analog_matrix_eeconfig_t *config) {
+    if (eeprom_read_dword((uint32_t *)EECONFIG_ANALOG_MATRIX_DATABLOCK) != (EECONFIG_ANALOG_MATRIX_DATA_VERSION)) {
+        return false;
+    }
+    eeprom_read_block(config, EECONFIG_ANALOG_MATRIX_DATABLOCK + sizeof(uint32_t), sizeof(analog_matrix_eeconfig_t));
+    return true;
+}
+void nvm_eeconfig_update_analog_matrix(const analog_matrix_eeconfig_t *config) {
+    eeprom_update_block(config, EECONFIG_ANALOG_MATRIX_DATABLOCK + sizeof(uint32_t), sizeof(analog_matrix_eeconfig_t));
+    eeprom_update_dword((uint32_t *)EECONFIG_ANALOG_MATRIX_DATABLOCK, (EECONFIG_ANALOG_MATRIX_DATA_VERSION));
+}
+void nvm_eeconfig_init_analog_matrix(void) {
+    // Only invalidated, the analog matrix writes its defaults and a fresh calibration on the next startup
+    eeprom_update_dword((uint32_t *)EECONFIG_ANALOG_MATRIX_DATABLOCK, 0);
+}
+#endif // ANALOG_MATRIX_ENABLE
+
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+uint8_t nvm_eeconfig_read_matrix_io_delay(void) {
+    return eeprom_read_byte(EECONFIG_MATRIX_IO_DELAY);
+}
+void nvm_eeconfig_update_matrix_io_delay(uint8_t val) {
+    eeprom_update_byte(EECONFIG_MATRIX_IO_DELAY, val);
+}
+#endif // MATRIX_IO_DELAY_CALIBRATION
+
 bool nvm_eeconfig_read_handedness(void) {
     return !!eeprom_read_byte(EECONFIG_HANDEDNESS);
 }
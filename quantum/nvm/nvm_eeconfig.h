@@ -93,6 +93,18 @@ void                              nvm_eeconfig_read_connection(connection_config
 void                              nvm_eeconfig_update_connection(const connection_config_t *config);
 #endif // CONNECTION_ENABLE
 
+#ifdef ANALOG_MATRIX_ENABLE
+typedef struct analog_matrix_eeconfig_t analog_matrix_eeconfig_t;
+bool                                    nvm_eeconfig_read_analog_matrix(analog_matrix_eeconfig_t *config);
+void                                    nvm_eeconfig_update_analog_matrix(const analog_matrix_eeconfig_t *config);
+void                                    nvm_eeconfig_init_analog_matrix(void);
+#endif // ANALOG_MATRIX_ENABLE
+
+#ifdef MATRIX_IO_DELAY_CALIBRATION
+uint8_t nvm_eeconfig_read_matrix_io_delay(void);
+void    nvm_eeconfig_update_matrix_io_delay(uint8_t val);
+#endif // MATRIX_IO_DELAY_CALIBRATION
+
 bool nvm_eeconfig_read_handedness(void);
 void nvm_eeconfig_update_handedness(bool val);
 
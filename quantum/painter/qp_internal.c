@@ -46,7 +46,7 @@ static void qp_internal_display_timeout_task(void) {
     static bool display_on                  = true;
     bool        should_change_display_state = false;
     bool        target_display_state        = false;
-    if (last_input_activity_elapsed() < (QUANTUM_PAINTER_DISPLAY_TIMEOUT)) {
+    if (render_input_activity_elapsed() < (QUANTUM_PAINTER_DISPLAY_TIMEOUT)) {
         should_change_display_state = display_on == false;
         target_display_state        = true;
     } else {
@@ -264,7 +264,7 @@ static bool try_activating_override(const uint16_t keycode, const uint8_t layer,
         }
 
         // Check layer
-        if ((override->layers & (1 << layer)) == 0) {
+        if ((override->layers & ((layer_state_t)1 << layer)) == 0) {
             key_override_printf("Not activating override: Not set to activate on pressed layer\n");
             continue;
         }
@@ -230,6 +230,9 @@ void shutdown_quantum(bool jump_to_bootloader) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_MIRROR)
+    dynamic_keymap_flush();
+#endif
 }
 
 void reset_keyboard(void) {
@@ -292,156 +295,195 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
-/* Core keycode function, hands off handling to other functions,
-    then processes internal quantum keycodes, and then processes
-    ACTIONs.                                                      */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
+typedef bool (*process_record_handler_t)(uint16_t keycode, keyrecord_t *record);
 
-    // This is how you use actions here
-    // if (keycode == QK_LEADER) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
+typedef struct process_record_dispatch_t {
+    uint16_t                 first;
+    uint16_t                 last;
+    process_record_handler_t handler;
+} process_record_dispatch_t;
 
-#if defined(SECURE_ENABLE)
-    if (!preprocess_secure(keycode, record)) {
-        return false;
-    }
-#endif
+// Handlers which need to observe every key event, rather than just their own keycodes
+#define ANY_KEYCODE 0x0000, 0xFFFF
 
-#ifdef TAP_DANCE_ENABLE
-    if (preprocess_tap_dance(keycode, record)) {
-        // The tap dance might have updated the layer state, therefore the
-        // result of the keycode lookup might change.
-        keycode = get_record_keycode(record, true);
-    }
-#endif
-
-#ifdef RGBLIGHT_ENABLE
-    if (record->event.pressed) {
-        preprocess_rgblight();
-    }
-#endif
-
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
+#ifdef KEY_OVERRIDE_ENABLE
+static bool process_key_override_dispatch(uint16_t keycode, keyrecord_t *record) {
+    return process_key_override(keycode, record);
+}
 #endif
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+/* Keycode processing order, each handler being invoked only for keycodes
+   within its declared range. Handlers still validate the keycode themselves,
+   so a range only needs to be a superset of what the handler acts upon. */
+static const process_record_dispatch_t process_record_dispatch[] PROGMEM = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    {ANY_KEYCODE, process_dynamic_macro},
 #endif
 #ifdef REPEAT_KEY_ENABLE
-            process_last_key(keycode, record) && process_repeat_key(keycode, record) &&
+    {ANY_KEYCODE, process_last_key},
+    {ANY_KEYCODE, process_repeat_key},
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    {ANY_KEYCODE, process_clicky},
 #endif
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    {ANY_KEYCODE, process_haptic},
 #endif
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
-            process_auto_mouse(keycode, record) &&
+    {ANY_KEYCODE, process_auto_mouse},
 #endif
-            process_record_modules(keycode, record) && // modules must run before kb
-            process_record_kb(keycode, record) &&
+    {ANY_KEYCODE, process_record_modules}, // modules must run before kb
+    {ANY_KEYCODE, process_record_kb},
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    {ANY_KEYCODE, process_record_via},
 #endif
 #if defined(SECURE_ENABLE)
-            process_secure(keycode, record) &&
+    {QK_QUANTUM, QK_QUANTUM_MAX, process_secure},
 #endif
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+    {QK_SEQUENCER, QK_SEQUENCER_MAX, process_sequencer},
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    {QK_MIDI, QK_MIDI_MAX, process_midi},
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    {QK_AUDIO, QK_AUDIO_MAX, process_audio},
 #endif
 #if defined(BACKLIGHT_ENABLE)
-            process_backlight(keycode, record) &&
+    {QK_LIGHTING, QK_LIGHTING_MAX, process_backlight},
 #endif
 #if defined(LED_MATRIX_ENABLE)
-            process_led_matrix(keycode, record) &&
+    {QK_LIGHTING, QK_LIGHTING_MAX, process_led_matrix},
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    {QK_STENO, QK_STENO_MAX, process_steno},
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    {ANY_KEYCODE, process_music},
 #endif
 #ifdef CAPS_WORD_ENABLE
-            process_caps_word(keycode, record) &&
+    {ANY_KEYCODE, process_caps_word},
 #endif
 #ifdef KEY_OVERRIDE_ENABLE
-            process_key_override(keycode, record) &&
+    {ANY_KEYCODE, process_key_override_dispatch},
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    {ANY_KEYCODE, process_tap_dance},
 #endif
 #if defined(UNICODE_COMMON_ENABLE)
-            process_unicode_common(keycode, record) &&
+#    if defined(UCIS_ENABLE)
+    {ANY_KEYCODE, process_unicode_common},
+#    else
+    {QK_QUANTUM, QK_QUANTUM_MAX, process_unicode_common},
+    {QK_UNICODE, QK_UNICODE_MAX, process_unicode_common},
+#    endif
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    {ANY_KEYCODE, process_leader},
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    {ANY_KEYCODE, process_auto_shift},
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+    {QK_QUANTUM, QK_QUANTUM_MAX, process_dynamic_tapping_term},
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    {ANY_KEYCODE, process_space_cadet},
 #endif
 #ifdef MAGIC_ENABLE
-            process_magic(keycode, record) &&
+    {QK_MAGIC, QK_MAGIC_MAX, process_magic},
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+    {QK_QUANTUM, QK_QUANTUM_MAX, process_grave_esc},
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_underglow(keycode, record) &&
+    {QK_LIGHTING, QK_LIGHTING_MAX, process_underglow},
 #endif
 #if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
+    {QK_LIGHTING, QK_LIGHTING_MAX, process_rgb_matrix},
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+    {QK_JOYSTICK, QK_JOYSTICK_MAX, process_joystick},
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+    {QK_PROGRAMMABLE_BUTTON, QK_PROGRAMMABLE_BUTTON_MAX, process_programmable_button},
 #endif
 #ifdef AUTOCORRECT_ENABLE
-            process_autocorrect(keycode, record) &&
+    {ANY_KEYCODE, process_autocorrect},
 #endif
 #ifdef TRI_LAYER_ENABLE
-            process_tri_layer(keycode, record) &&
+    {QK_QUANTUM, QK_QUANTUM_MAX, process_tri_layer},
 #endif
 #if !defined(NO_ACTION_LAYER)
-            process_default_layer(keycode, record) &&
+    {QK_PERSISTENT_DEF_LAYER, QK_PERSISTENT_DEF_LAYER_MAX, process_default_layer},
 #endif
 #ifdef LAYER_LOCK_ENABLE
-            process_layer_lock(keycode, record) &&
+    {ANY_KEYCODE, process_layer_lock},
 #endif
 #ifdef CONNECTION_ENABLE
-            process_connection(keycode, record) &&
+    {QK_CONNECTION, QK_CONNECTION_MAX, process_connection},
 #endif
-            true)) {
+};
+
+/* Core keycode function, hands off handling to other functions,
+    then processes internal quantum keycodes, and then processes
+    ACTIONs.                                                      */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // This is how you use actions here
+    // if (keycode == QK_LEADER) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#if defined(SECURE_ENABLE)
+    if (!preprocess_secure(keycode, record)) {
+        return false;
+    }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    if (preprocess_tap_dance(keycode, record)) {
+        // The tap dance might have updated the layer state, therefore the
+        // result of the keycode lookup might change.
+        keycode = get_record_keycode(record, true);
+    }
+#endif
+
+#ifdef RGBLIGHT_ENABLE
+    if (record->event.pressed) {
+        preprocess_rgblight();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
         return false;
     }
+#endif
+
+    // Only visit the handlers whose keycode range covers this key, stopping at the first one which consumes it
+    for (uint8_t i = 0; i < ARRAY_SIZE(process_record_dispatch); i++) {
+        const process_record_dispatch_t *entry = &process_record_dispatch[i];
+        if (keycode < pgm_read_word(&entry->first) || keycode > pgm_read_word(&entry->last)) {
+            continue;
+        }
+        process_record_handler_t handler = (process_record_handler_t)pgm_read_ptr(&entry->handler);
+        if (!handler(keycode, record)) {
+            return false;
+        }
+    }
 
     if (record->event.pressed) {
         switch (keycode) {
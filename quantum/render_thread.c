@@ -0,0 +1,41 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "render_thread.h"
+#include "action_util.h"
+#include "host.h"
+#include "keyboard.h"
+
+static render_state_t published_state;
+static render_state_t current_state;
+
+void render_thread_publish(void) {
+    published_state.layer_state         = layer_state;
+    published_state.default_layer_state = default_layer_state;
+    published_state.mods                = get_mods();
+    published_state.weak_mods           = get_weak_mods();
+    published_state.oneshot_mods        = get_oneshot_mods();
+    published_state.led_state           = host_keyboard_led_state();
+    published_state.last_input_activity = last_input_activity_time();
+}
+
+const render_state_t *render_thread_state(void) {
+    return &current_state;
+}
+
+void render_thread_task(void) {
+    render_thread_lock();
+
+    uint32_t last_input_activity = current_state.last_input_activity;
+
+    current_state = published_state;
+
+    keyboard_render_task(current_state.last_input_activity != last_input_activity);
+
+#ifdef QUANTUM_PAINTER_ENABLE
+    void qp_internal_task(void);
+    qp_internal_task();
+#endif
+
+    render_thread_unlock();
+}
@@ -0,0 +1,96 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action_layer.h"
+#include "led.h"
+
+/*
+    Threaded mode: lighting, displays and Quantum Painter run in a separate
+    render thread every RENDER_THREAD_INTERVAL_MS, instead of inline in every
+    iteration of the main loop (matrix scan, debounce, keycode processing and
+    report sending). A render pass blocks on bus transfers without holding up
+    the main loop beyond the pass already in progress.
+
+    The two threads never run keyboard code at the same time. The main thread
+    holds the render lock for each iteration and only releases it inside
+    render_thread_main_loop_wait(); the render thread holds it for each pass.
+    Lighting configuration, hit trackers and driver buffers are therefore never
+    touched concurrently, and a configuration change made by the main thread
+    takes effect from the next frame rendered.
+
+    By default both threads share a priority: the main loop runs freely and
+    yields once per iteration, and a pending render pass runs in that gap. If
+    MAIN_LOOP_RATE_HZ is defined, the main loop is instead raised above the
+    render thread and paced at that rate, handing the render thread the rest of
+    each period.
+
+    State used for rendering is published by the main loop once per iteration.
+    Code running in the render thread (lighting indicators, OLED/painter drawing)
+    should read it through render_thread_state(); the core lighting and display
+    timeouts do so through render_input_activity_elapsed().
+
+    I2C and SPI transactions from both threads are serialised by the ChibiOS bus
+    mutexes, so *_USE_MUTUAL_EXCLUSION must be enabled for every bus in use.
+    The task profiler only records main thread stages.
+*/
+
+#ifndef RENDER_THREAD_STACK_SIZE
+#    define RENDER_THREAD_STACK_SIZE 2048
+#endif
+
+#ifndef RENDER_THREAD_INTERVAL_MS
+#    define RENDER_THREAD_INTERVAL_MS 1
+#endif
+
+typedef struct render_state_t {
+    layer_state_t layer_state;
+    layer_state_t default_layer_state;
+    uint8_t       mods;
+    uint8_t       weak_mods;
+    uint8_t       oneshot_mods;
+    led_t         led_state;
+    uint32_t      last_input_activity;
+} render_state_t;
+
+/**
+ * \brief Publishes the current keyboard state for the render thread. Invoked by the main loop every iteration.
+ */
+void render_thread_publish(void);
+
+/**
+ * \brief Returns the snapshot taken at the start of the current render pass. Only valid from the render thread.
+ */
+const render_state_t *render_thread_state(void);
+
+/**
+ * \brief A single render pass. Invoked repeatedly by the render thread.
+ */
+void render_thread_task(void);
+
+/**
+ * \brief Lighting and display tasks, implemented in keyboard.c.
+ */
+void keyboard_render_task(bool activity_has_occurred);
+
+// Platform implementation
+
+/**
+ * \brief Takes the render lock for the calling thread and starts the render thread.
+ */
+void render_thread_init(void);
+
+/**
+ * \brief Releases the render lock and lets the render thread run, then takes the lock back.
+ * Yields once by default, or blocks until the next period of MAIN_LOOP_RATE_HZ (at least one system tick) if defined.
+ */
+void render_thread_main_loop_wait(void);
+
+/**
+ * \brief Serialises the main loop and render passes.
+ */
+void render_thread_lock(void);
+void render_thread_unlock(void);
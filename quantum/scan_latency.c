@@ -0,0 +1,226 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "scan_latency.h"
+#include "timer.h"
+#include "progmem.h"
+#include "util.h"
+#include "print.h"
+#include "debug.h"
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    include "chibios_config.h"
+#endif
+
+#if defined(SCAN_LATENCY_TIMESTAMP)
+#    ifndef SCAN_LATENCY_TIMESTAMP_FREQUENCY
+#        error SCAN_LATENCY_TIMESTAMP_FREQUENCY must be defined along with SCAN_LATENCY_TIMESTAMP()
+#    endif
+#elif defined(PROTOCOL_CHIBIOS) && PORT_SUPPORTS_RT == TRUE
+#    define SCAN_LATENCY_TIMESTAMP() ((uint32_t)chSysGetRealtimeCounterX())
+#    define SCAN_LATENCY_TIMESTAMP_FREQUENCY REALTIME_COUNTER_CLOCK
+#else
+#    define SCAN_LATENCY_TIMESTAMP() timer_read32()
+#    define SCAN_LATENCY_TIMESTAMP_FREQUENCY 1000
+#endif
+
+typedef struct scan_latency_state_t {
+    uint16_t counts[SCAN_LATENCY_BUCKET_COUNT];
+    uint32_t samples;
+    uint32_t max;
+} scan_latency_state_t;
+
+// Upper edge of each bucket in microseconds, the last one catches everything else
+static const uint32_t PROGMEM bucket_edges[SCAN_LATENCY_BUCKET_COUNT] = {10, 20, 30, 40, 50, 75, 100, 200, 300, 400, 500, 750, 1000, 2000, 3000, 4000, 5000, 7500, 10000, 20000, 30000, 40000, 50000, 75000, 100000, 200000, 300000, 400000, 500000, 750000, 1000000, UINT32_MAX};
+
+static scan_latency_state_t histograms[SCAN_LATENCY_HISTOGRAM_COUNT];
+static uint32_t             last_scan      = 0;
+static uint32_t             change_time    = 0;
+static bool                 has_last_scan  = false;
+static bool                 change_pending = false;
+
+static const char *const histogram_names[SCAN_LATENCY_HISTOGRAM_COUNT] = {
+    [SCAN_LATENCY_SCAN_INTERVAL] = "scan_interval",
+    [SCAN_LATENCY_KEY_TO_REPORT] = "key_to_report",
+};
+
+static inline uint32_t bucket_edge(uint8_t bucket) {
+    return pgm_read_dword(&bucket_edges[bucket]);
+}
+
+// The frequency is a compile time constant, so only one of these branches survives
+static inline uint32_t ticks_to_us(uint32_t ticks) {
+    if ((SCAN_LATENCY_TIMESTAMP_FREQUENCY) % 1000000 == 0) {
+        return ticks / ((SCAN_LATENCY_TIMESTAMP_FREQUENCY) / 1000000 ? (SCAN_LATENCY_TIMESTAMP_FREQUENCY) / 1000000 : 1);
+    }
+    if (1000000 % (SCAN_LATENCY_TIMESTAMP_FREQUENCY) == 0) {
+        return ticks * (1000000 / (SCAN_LATENCY_TIMESTAMP_FREQUENCY));
+    }
+    return (uint32_t)(((uint64_t)ticks * 1000000) / (SCAN_LATENCY_TIMESTAMP_FREQUENCY));
+}
+
+static void record(scan_latency_histogram_t histogram, uint32_t us) {
+    scan_latency_state_t *state = &histograms[histogram];
+
+    // Binary search for the first bucket whose edge is not below the sample
+    uint8_t low = 0, high = SCAN_LATENCY_BUCKET_COUNT - 1;
+    while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        if (us > bucket_edge(mid)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (state->counts[low] == UINT16_MAX) {
+        // Halve every bucket rather than saturate one, the shape of the distribution is kept
+        for (uint8_t i = 0; i < SCAN_LATENCY_BUCKET_COUNT; i++) {
+            state->counts[i] /= 2;
+        }
+    }
+    state->counts[low]++;
+    state->samples++;
+    if (us > state->max) {
+        state->max = us;
+    }
+}
+
+void scan_latency_scan_begin(void) {
+    uint32_t now = SCAN_LATENCY_TIMESTAMP();
+    if (has_last_scan) {
+        record(SCAN_LATENCY_SCAN_INTERVAL, ticks_to_us(now - last_scan));
+    }
+    last_scan     = now;
+    has_last_scan = true;
+}
+
+void scan_latency_matrix_changed(void) {
+    change_time    = last_scan;
+    change_pending = true;
+}
+
+void scan_latency_scan_end(void) {
+    // A report sent later is caused by something else, e.g. a tapping term expiring
+    change_pending = false;
+}
+
+void scan_latency_report_sent(void) {
+    if (change_pending) {
+        record(SCAN_LATENCY_KEY_TO_REPORT, ticks_to_us(SCAN_LATENCY_TIMESTAMP() - change_time));
+        change_pending = false;
+    }
+}
+
+const char *scan_latency_histogram_name(scan_latency_histogram_t histogram) {
+    if (histogram >= SCAN_LATENCY_HISTOGRAM_COUNT) {
+        return "unknown";
+    }
+    return histogram_names[histogram];
+}
+
+uint16_t scan_latency_get_bucket(scan_latency_histogram_t histogram, uint8_t bucket, uint32_t *upper_us) {
+    if (histogram >= SCAN_LATENCY_HISTOGRAM_COUNT || bucket >= SCAN_LATENCY_BUCKET_COUNT) {
+        return 0;
+    }
+    if (upper_us) {
+        *upper_us = bucket_edge(bucket);
+    }
+    return histograms[histogram].counts[bucket];
+}
+
+static uint32_t percentile(const scan_latency_state_t *state, uint32_t total, uint8_t percent) {
+    uint32_t target     = (total * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < SCAN_LATENCY_BUCKET_COUNT; i++) {
+        cumulative += state->counts[i];
+        if (cumulative >= target) {
+            // The bucket edge may be well above anything actually seen
+            return MIN(bucket_edge(i), state->max);
+        }
+    }
+    return state->max;
+}
+
+bool scan_latency_get_stats(scan_latency_histogram_t histogram, scan_latency_stats_t *stats) {
+    if (histogram >= SCAN_LATENCY_HISTOGRAM_COUNT || histograms[histogram].samples == 0) {
+        return false;
+    }
+
+    const scan_latency_state_t *state = &histograms[histogram];
+    uint32_t                    total = 0;
+    for (uint8_t i = 0; i < SCAN_LATENCY_BUCKET_COUNT; i++) {
+        total += state->counts[i];
+    }
+
+    stats->samples = state->samples;
+    stats->p50     = percentile(state, total, 50);
+    stats->p99     = percentile(state, total, 99);
+    stats->max     = state->max;
+    return true;
+}
+
+void scan_latency_reset(void) {
+    memset(histograms, 0, sizeof(histograms));
+    has_last_scan  = false;
+    change_pending = false;
+}
+
+void scan_latency_print(void) {
+    scan_latency_stats_t stats;
+    for (uint8_t histogram = 0; histogram < SCAN_LATENCY_HISTOGRAM_COUNT; histogram++) {
+        if (scan_latency_get_stats(histogram, &stats)) {
+            dprintf("%-14s n:%lu p50:%luus p99:%luus max:%luus\n", scan_latency_histogram_name(histogram), stats.samples, stats.p50, stats.p99, stats.max);
+        }
+    }
+}
+
+void scan_latency_task(void) {
+#if SCAN_LATENCY_PRINT_INTERVAL > 0
+    static uint32_t last_print = 0;
+    if (timer_elapsed32(last_print) >= SCAN_LATENCY_PRINT_INTERVAL) {
+        last_print = timer_read32();
+        scan_latency_print();
+    }
+#endif
+}
+
+static inline uint8_t *pack_u32(uint8_t *dest, uint32_t value) {
+    *dest++ = (value >> 24) & 0xFF;
+    *dest++ = (value >> 16) & 0xFF;
+    *dest++ = (value >> 8) & 0xFF;
+    *dest++ = value & 0xFF;
+    return dest;
+}
+
+bool scan_latency_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 19 || data[0] != SCAN_LATENCY_RAW_HID_ID) {
+        return false;
+    }
+
+    uint8_t histogram = data[1];
+    memset(&data[2], 0, length - 2);
+    if (histogram == 0xFF) {
+        scan_latency_reset();
+    } else {
+        scan_latency_stats_t stats = {0};
+        scan_latency_get_stats(histogram, &stats);
+
+        uint8_t *ptr = &data[2];
+        *ptr++       = SCAN_LATENCY_HISTOGRAM_COUNT;
+        ptr          = pack_u32(ptr, stats.samples);
+        ptr          = pack_u32(ptr, stats.p50);
+        ptr          = pack_u32(ptr, stats.p99);
+        pack_u32(ptr, stats.max);
+    }
+
+#ifdef RAW_ENABLE
+    raw_hid_send(data, length);
+#endif
+    return true;
+}
@@ -0,0 +1,140 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+    Matrix scan jitter and key latency instrumentation.
+
+    When SCAN_LATENCY_ENABLE is set, two histograms are kept:
+
+      - the interval between consecutive matrix scans,
+      - the latency from the start of a matrix scan which found a change, to
+        the first keyboard report handed to the host driver while processing
+        that scan. Changes which send no report themselves, such as layer keys
+        or undecided tap-hold keys, are not sampled.
+
+    Samples are sorted into SCAN_LATENCY_BUCKET_COUNT fixed buckets on a
+    1-2-3-4-5-7.5 microsecond scale, so recording is constant time and memory
+    use does not grow with the number of samples. p50/p99 are reported as the
+    upper edge of the bucket they fall in, the maximum is exact.
+
+    Timestamps are taken with SCAN_LATENCY_TIMESTAMP(), which defaults to the
+    realtime counter on ChibiOS, and falls back to timer_read32() elsewhere, in
+    which case values only have millisecond resolution.
+*/
+
+#ifndef SCAN_LATENCY_PRINT_INTERVAL
+#    define SCAN_LATENCY_PRINT_INTERVAL 5000
+#endif
+
+#ifndef SCAN_LATENCY_RAW_HID_ID
+#    define SCAN_LATENCY_RAW_HID_ID 0xF1
+#endif
+
+#define SCAN_LATENCY_BUCKET_COUNT 32
+
+typedef enum scan_latency_histogram_t {
+    SCAN_LATENCY_SCAN_INTERVAL,
+    SCAN_LATENCY_KEY_TO_REPORT,
+    SCAN_LATENCY_HISTOGRAM_COUNT,
+} scan_latency_histogram_t;
+
+typedef struct scan_latency_stats_t {
+    uint32_t samples;
+    uint32_t p50; // microseconds
+    uint32_t p99; // microseconds
+    uint32_t max; // microseconds
+} scan_latency_stats_t;
+
+#ifdef SCAN_LATENCY_ENABLE
+
+/**
+ * \brief Marks the start of a matrix scan, recording the interval since the previous one.
+ */
+void scan_latency_scan_begin(void);
+
+/**
+ * \brief Marks the scan started by the last scan_latency_scan_begin() as having found a key change.
+ */
+void scan_latency_matrix_changed(void);
+
+/**
+ * \brief Marks the end of processing the changes found by the current scan. Later reports are not attributed to it.
+ */
+void scan_latency_scan_end(void);
+
+/**
+ * \brief Marks a keyboard report as sent, recording the latency since the start of the scan being processed.
+ */
+void scan_latency_report_sent(void);
+
+/**
+ * \brief Computes the statistics of the given histogram.
+ *
+ * \return false if the histogram is invalid or has no samples yet
+ */
+bool scan_latency_get_stats(scan_latency_histogram_t histogram, scan_latency_stats_t *stats);
+
+/**
+ * \brief Returns the sample count of a histogram bucket, and optionally its upper edge in microseconds.
+ */
+uint16_t scan_latency_get_bucket(scan_latency_histogram_t histogram, uint8_t bucket, uint32_t *upper_us);
+
+/**
+ * \brief Returns a printable name for the given histogram.
+ */
+const char *scan_latency_histogram_name(scan_latency_histogram_t histogram);
+
+/**
+ * \brief Clears all recorded samples.
+ */
+void scan_latency_reset(void);
+
+/**
+ * \brief Dumps the statistics of all histograms which have samples over console.
+ */
+void scan_latency_print(void);
+
+/**
+ * \brief Periodically dumps statistics over console, every SCAN_LATENCY_PRINT_INTERVAL milliseconds. Set the interval to 0 to disable.
+ */
+void scan_latency_task(void);
+
+/**
+ * \brief Handles a raw HID latency query.
+ *
+ * Request:  [SCAN_LATENCY_RAW_HID_ID, histogram]
+ * Response: [SCAN_LATENCY_RAW_HID_ID, histogram, histogram count, samples, p50, p99, max (u32)], big-endian, in microseconds.
+ * A histogram value of 0xFF resets all statistics.
+ *
+ * Intended to be called from raw_hid_receive() or via_command_kb().
+ *
+ * \return true if the report was a latency query and a response was sent
+ */
+bool scan_latency_raw_hid_receive(uint8_t *data, uint8_t length);
+
+#    define SCAN_LATENCY_SCAN_BEGIN() scan_latency_scan_begin()
+#    define SCAN_LATENCY_MATRIX_CHANGED() scan_latency_matrix_changed()
+#    define SCAN_LATENCY_SCAN_END() scan_latency_scan_end()
+#    define SCAN_LATENCY_REPORT_SENT() scan_latency_report_sent()
+
+#else
+
+#    define SCAN_LATENCY_SCAN_BEGIN() \
+        do {                          \
+        } while (0)
+#    define SCAN_LATENCY_MATRIX_CHANGED() \
+        do {                              \
+        } while (0)
+#    define SCAN_LATENCY_SCAN_END() \
+        do {                        \
+        } while (0)
+#    define SCAN_LATENCY_REPORT_SENT() \
+        do {                           \
+        } while (0)
+
+#endif // SCAN_LATENCY_ENABLE
@@ -0,0 +1,196 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_profiler.h"
+#include "timer.h"
+#include "progmem.h"
+#include "print.h"
+#include "debug.h"
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#endif
+
+#if defined(TASK_PROFILER_TIMESTAMP)
+#    define TASK_PROFILER_UNIT TASK_PROFILER_UNIT_TICKS
+#elif defined(PROTOCOL_CHIBIOS) && PORT_SUPPORTS_RT == TRUE
+#    define TASK_PROFILER_TIMESTAMP() ((uint32_t)chSysGetRealtimeCounterX())
+#    define TASK_PROFILER_UNIT TASK_PROFILER_UNIT_CYCLES
+#else
+#    define TASK_PROFILER_TIMESTAMP() timer_read32()
+#    define TASK_PROFILER_UNIT TASK_PROFILER_UNIT_MS
+#endif
+
+typedef struct task_profiler_ring_t {
+    uint32_t start;
+    uint32_t max_ever;
+    uint16_t count;
+    uint8_t  head;
+    uint32_t samples[TASK_PROFILER_RING_SIZE];
+} task_profiler_ring_t;
+
+static task_profiler_ring_t rings[TASK_PROFILER_STAGE_COUNT];
+
+// Long enough for the longest name, "pointing_device_task"
+#define STAGE_NAME_SIZE 21
+
+static const char PROGMEM stage_names[TASK_PROFILER_STAGE_COUNT][STAGE_NAME_SIZE] = {
+    [TASK_PROFILER_KEYBOARD_TASK]        = "keyboard_task",
+    [TASK_PROFILER_MATRIX_TASK]          = "matrix_task",
+    [TASK_PROFILER_QUANTUM_TASK]         = "quantum_task",
+    [TASK_PROFILER_SPLIT_WATCHDOG_TASK]  = "split_watchdog_task",
+    [TASK_PROFILER_RGBLIGHT_TASK]        = "rgblight_task",
+    [TASK_PROFILER_LED_MATRIX_TASK]      = "led_matrix_task",
+    [TASK_PROFILER_RGB_MATRIX_TASK]      = "rgb_matrix_task",
+    [TASK_PROFILER_BACKLIGHT_TASK]       = "backlight_task",
+    [TASK_PROFILER_ENCODER_TASK]         = "encoder_task",
+    [TASK_PROFILER_POINTING_DEVICE_TASK] = "pointing_device_task",
+    [TASK_PROFILER_OLED_TASK]            = "oled_task",
+    [TASK_PROFILER_ST7565_TASK]          = "st7565_task",
+    [TASK_PROFILER_MOUSEKEY_TASK]        = "mousekey_task",
+    [TASK_PROFILER_PS2_MOUSE_TASK]       = "ps2_mouse_task",
+    [TASK_PROFILER_MIDI_TASK]            = "midi_task",
+    [TASK_PROFILER_JOYSTICK_TASK]        = "joystick_task",
+    [TASK_PROFILER_BATTERY_TASK]         = "battery_task",
+    [TASK_PROFILER_BLUETOOTH_TASK]       = "bluetooth_task",
+    [TASK_PROFILER_HAPTIC_TASK]          = "haptic_task",
+    [TASK_PROFILER_LED_TASK]             = "led_task",
+    [TASK_PROFILER_OS_DETECTION_TASK]    = "os_detection_task",
+    [TASK_PROFILER_RAW_HID_TASK]         = "raw_hid_task",
+    [TASK_PROFILER_CONSOLE_TASK]         = "console_task",
+    [TASK_PROFILER_QUANTUM_PAINTER_TASK] = "qp_internal_task",
+    [TASK_PROFILER_DEFERRED_EXEC_TASK]   = "deferred_exec_task",
+    [TASK_PROFILER_HOUSEKEEPING_TASK]    = "housekeeping_task",
+};
+
+void task_profiler_begin(task_profiler_stage_t stage) {
+    rings[stage].start = TASK_PROFILER_TIMESTAMP();
+}
+
+void task_profiler_end(task_profiler_stage_t stage) {
+    uint32_t              now     = TASK_PROFILER_TIMESTAMP();
+    task_profiler_ring_t *ring    = &rings[stage];
+    uint32_t              elapsed = now - ring->start;
+
+    ring->samples[ring->head] = elapsed;
+    ring->head                = (ring->head + 1) & (TASK_PROFILER_RING_SIZE - 1);
+    if (ring->count < TASK_PROFILER_RING_SIZE) {
+        ring->count++;
+    }
+    if (elapsed > ring->max_ever) {
+        ring->max_ever = elapsed;
+    }
+}
+
+const char *task_profiler_stage_name(task_profiler_stage_t stage) {
+    static char name[STAGE_NAME_SIZE];
+    if (stage >= TASK_PROFILER_STAGE_COUNT) {
+        return "unknown";
+    }
+    strcpy_P(name, stage_names[stage]);
+    return name;
+}
+
+bool task_profiler_get_stats(task_profiler_stage_t stage, task_profiler_stats_t *stats) {
+    if (stage >= TASK_PROFILER_STAGE_COUNT || rings[stage].count == 0) {
+        return false;
+    }
+
+    const task_profiler_ring_t *ring  = &rings[stage];
+    uint16_t                    count = ring->count;
+
+    // Copy out and insertion-sort the window, it's small enough that anything smarter isn't worth the flash
+    uint32_t sorted[TASK_PROFILER_RING_SIZE];
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t value = ring->samples[i];
+        uint16_t j     = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+        sum += value;
+    }
+
+    stats->samples  = count;
+    stats->min      = sorted[0];
+    stats->max      = sorted[count - 1];
+    stats->avg      = (uint32_t)(sum / count);
+    stats->p99      = sorted[((uint32_t)count * 99) / 100];
+    stats->max_ever = ring->max_ever;
+    return true;
+}
+
+task_profiler_unit_t task_profiler_unit(void) {
+    return TASK_PROFILER_UNIT;
+}
+
+void task_profiler_reset(void) {
+    memset(rings, 0, sizeof(rings));
+}
+
+void task_profiler_print(void) {
+    task_profiler_stats_t stats;
+    dprintf("task profiler (%s)\n", TASK_PROFILER_UNIT == TASK_PROFILER_UNIT_CYCLES ? "cycles" : TASK_PROFILER_UNIT == TASK_PROFILER_UNIT_MS ? "ms" : "ticks");
+    for (uint8_t stage = 0; stage < TASK_PROFILER_STAGE_COUNT; stage++) {
+        if (task_profiler_get_stats(stage, &stats)) {
+            dprintf("%-20s min:%lu avg:%lu max:%lu p99:%lu max_ever:%lu\n", task_profiler_stage_name(stage), stats.min, stats.avg, stats.max, stats.p99, stats.max_ever);
+        }
+    }
+}
+
+void task_profiler_task(void) {
+#if TASK_PROFILER_PRINT_INTERVAL > 0
+    static uint32_t last_print = 0;
+    if (timer_elapsed32(last_print) >= TASK_PROFILER_PRINT_INTERVAL) {
+        last_print = timer_read32();
+        task_profiler_print();
+    }
+#endif
+}
+
+static inline uint8_t *pack_u32(uint8_t *dest, uint32_t value) {
+    *dest++ = (value >> 24) & 0xFF;
+    *dest++ = (value >> 16) & 0xFF;
+    *dest++ = (value >> 8) & 0xFF;
+    *dest++ = value & 0xFF;
+    return dest;
+}
+
+bool task_profiler_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 25 || data[0] != TASK_PROFILER_RAW_HID_ID) {
+        return false;
+    }
+
+    uint8_t stage = data[1];
+    memset(&data[2], 0, length - 2);
+    if (stage == 0xFF) {
+        task_profiler_reset();
+    } else {
+        task_profiler_stats_t stats = {0};
+        task_profiler_get_stats(stage, &stats);
+
+        uint8_t *ptr = &data[2];
+        *ptr++       = TASK_PROFILER_STAGE_COUNT;
+        *ptr++       = (stats.samples >> 8) & 0xFF;
+        *ptr++       = stats.samples & 0xFF;
+        ptr          = pack_u32(ptr, stats.min);
+        ptr          = pack_u32(ptr, stats.avg);
+        ptr          = pack_u32(ptr, stats.max);
+        ptr          = pack_u32(ptr, stats.p99);
+        ptr          = pack_u32(ptr, stats.max_ever);
+        if (length > 25) {
+            *ptr = TASK_PROFILER_UNIT;
+        }
+    }
+
+#ifdef RAW_ENABLE
+    raw_hid_send(data, length);
+#endif
+    return true;
+}
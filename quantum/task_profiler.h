@@ -0,0 +1,160 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+    Per-task profiler for the main loop.
+
+    When TASK_PROFILER_ENABLE is set, every stage of keyboard_task() and the
+    main loop is timestamped, and the most recent TASK_PROFILER_RING_SIZE
+    samples for each stage are kept in a fixed ring. Statistics (min/avg/max/p99)
+    are derived from that ring on request, and can be dumped over console or
+    queried over raw HID.
+
+    Timestamps are taken with TASK_PROFILER_TIMESTAMP(), which defaults to the
+    realtime (cycle) counter on ChibiOS ports which support it, and falls back
+    to timer_read32() elsewhere, in which case samples only have millisecond
+    resolution. The unit in use is reported alongside the statistics.
+*/
+
+#ifndef TASK_PROFILER_RING_SIZE
+#    if defined(__AVR__)
+// Every stage has a ring whether or not it is compiled in, 32 samples each would not fit in AVR RAM
+#        define TASK_PROFILER_RING_SIZE 4
+#    else
+#        define TASK_PROFILER_RING_SIZE 32
+#    endif
+#endif
+
+#if (TASK_PROFILER_RING_SIZE & (TASK_PROFILER_RING_SIZE - 1)) != 0
+#    error TASK_PROFILER_RING_SIZE must be a power of two
+#endif
+
+#ifndef TASK_PROFILER_PRINT_INTERVAL
+#    define TASK_PROFILER_PRINT_INTERVAL 5000
+#endif
+
+#ifndef TASK_PROFILER_RAW_HID_ID
+#    define TASK_PROFILER_RAW_HID_ID 0xF0
+#endif
+
+typedef enum task_profiler_stage_t {
+    TASK_PROFILER_KEYBOARD_TASK,
+    TASK_PROFILER_MATRIX_TASK,
+    TASK_PROFILER_QUANTUM_TASK,
+    TASK_PROFILER_SPLIT_WATCHDOG_TASK,
+    TASK_PROFILER_RGBLIGHT_TASK,
+    TASK_PROFILER_LED_MATRIX_TASK,
+    TASK_PROFILER_RGB_MATRIX_TASK,
+    TASK_PROFILER_BACKLIGHT_TASK,
+    TASK_PROFILER_ENCODER_TASK,
+    TASK_PROFILER_POINTING_DEVICE_TASK,
+    TASK_PROFILER_OLED_TASK,
+    TASK_PROFILER_ST7565_TASK,
+    TASK_PROFILER_MOUSEKEY_TASK,
+    TASK_PROFILER_PS2_MOUSE_TASK,
+    TASK_PROFILER_MIDI_TASK,
+    TASK_PROFILER_JOYSTICK_TASK,
+    TASK_PROFILER_BATTERY_TASK,
+    TASK_PROFILER_BLUETOOTH_TASK,
+    TASK_PROFILER_HAPTIC_TASK,
+    TASK_PROFILER_LED_TASK,
+    TASK_PROFILER_OS_DETECTION_TASK,
+    TASK_PROFILER_RAW_HID_TASK,
+    TASK_PROFILER_CONSOLE_TASK,
+    TASK_PROFILER_QUANTUM_PAINTER_TASK,
+    TASK_PROFILER_DEFERRED_EXEC_TASK,
+    TASK_PROFILER_HOUSEKEEPING_TASK,
+    TASK_PROFILER_STAGE_COUNT,
+} task_profiler_stage_t;
+
+typedef enum task_profiler_unit_t {
+    TASK_PROFILER_UNIT_MS,     // timer_read32() fallback
+    TASK_PROFILER_UNIT_CYCLES, // ChibiOS realtime counter
+    TASK_PROFILER_UNIT_TICKS,  // user supplied TASK_PROFILER_TIMESTAMP()
+} task_profiler_unit_t;
+
+typedef struct task_profiler_stats_t {
+    uint16_t samples; // number of samples the statistics were derived from
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+    uint32_t max_ever; // largest sample seen since the last reset, including samples which have left the ring
+} task_profiler_stats_t;
+
+#ifdef TASK_PROFILER_ENABLE
+
+/**
+ * \brief Marks the start of a profiled stage.
+ */
+void task_profiler_begin(task_profiler_stage_t stage);
+
+/**
+ * \brief Marks the end of a profiled stage, recording the elapsed time since the matching task_profiler_begin().
+ */
+void task_profiler_end(task_profiler_stage_t stage);
+
+/**
+ * \brief Computes the statistics for the given stage from the samples currently held in its ring.
+ *
+ * \return false if the stage is invalid or has no samples yet
+ */
+bool task_profiler_get_stats(task_profiler_stage_t stage, task_profiler_stats_t *stats);
+
+/**
+ * \brief Returns a printable name for the given stage. The names are kept in flash, the returned copy is only valid until the next call.
+ */
+const char *task_profiler_stage_name(task_profiler_stage_t stage);
+
+/**
+ * \brief Returns the unit the recorded samples are measured in.
+ */
+task_profiler_unit_t task_profiler_unit(void);
+
+/**
+ * \brief Clears all recorded samples.
+ */
+void task_profiler_reset(void);
+
+/**
+ * \brief Dumps the statistics for all stages which have samples over console.
+ */
+void task_profiler_print(void);
+
+/**
+ * \brief Periodically dumps statistics over console, every TASK_PROFILER_PRINT_INTERVAL milliseconds. Set the interval to 0 to disable.
+ */
+void task_profiler_task(void);
+
+/**
+ * \brief Handles a raw HID profiler query.
+ *
+ * Request:  [TASK_PROFILER_RAW_HID_ID, stage]
+ * Response: [TASK_PROFILER_RAW_HID_ID, stage, stage count, samples (u16), min, avg, max, p99, max_ever (u32), unit], big-endian.
+ * The trailing task_profiler_unit_t byte is only present on reports longer than 25 bytes.
+ * A stage value of 0xFF resets all statistics.
+ *
+ * Intended to be called from raw_hid_receive() or via_command_kb().
+ *
+ * \return true if the report was a profiler query and a response was sent
+ */
+bool task_profiler_raw_hid_receive(uint8_t *data, uint8_t length);
+
+#    define TASK_PROFILER_BEGIN(stage) task_profiler_begin(stage)
+#    define TASK_PROFILER_END(stage) task_profiler_end(stage)
+
+#else
+
+#    define TASK_PROFILER_BEGIN(stage) \
+        do {                           \
+        } while (0)
+#    define TASK_PROFILER_END(stage) \
+        do {                         \
+        } while (0)
+
+#endif // TASK_PROFILER_ENABLE
@@ -0,0 +1,168 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "task_scheduler.h"
+#include "deferred_exec.h"
+#include "timer.h"
+
+#ifndef TASK_SCHEDULER_RGBLIGHT_PERIOD
+#    define TASK_SCHEDULER_RGBLIGHT_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_LED_MATRIX_PERIOD
+#    define TASK_SCHEDULER_LED_MATRIX_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_RGB_MATRIX_PERIOD
+#    define TASK_SCHEDULER_RGB_MATRIX_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_BACKLIGHT_PERIOD
+#    define TASK_SCHEDULER_BACKLIGHT_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_OLED_PERIOD
+#    define TASK_SCHEDULER_OLED_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_ST7565_PERIOD
+#    define TASK_SCHEDULER_ST7565_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_HAPTIC_PERIOD
+#    define TASK_SCHEDULER_HAPTIC_PERIOD 1
+#endif
+#ifndef TASK_SCHEDULER_BATTERY_PERIOD
+#    define TASK_SCHEDULER_BATTERY_PERIOD 10
+#endif
+#ifndef TASK_SCHEDULER_QUANTUM_PAINTER_PERIOD
+#    define TASK_SCHEDULER_QUANTUM_PAINTER_PERIOD 1
+#endif
+
+// Higher values win when two released tasks share the same deadline
+#ifndef TASK_SCHEDULER_RGBLIGHT_PRIORITY
+#    define TASK_SCHEDULER_RGBLIGHT_PRIORITY 1
+#endif
+#ifndef TASK_SCHEDULER_LED_MATRIX_PRIORITY
+#    define TASK_SCHEDULER_LED_MATRIX_PRIORITY 1
+#endif
+#ifndef TASK_SCHEDULER_RGB_MATRIX_PRIORITY
+#    define TASK_SCHEDULER_RGB_MATRIX_PRIORITY 1
+#endif
+#ifndef TASK_SCHEDULER_BACKLIGHT_PRIORITY
+#    define TASK_SCHEDULER_BACKLIGHT_PRIORITY 2
+#endif
+#ifndef TASK_SCHEDULER_OLED_PRIORITY
+#    define TASK_SCHEDULER_OLED_PRIORITY 0
+#endif
+#ifndef TASK_SCHEDULER_ST7565_PRIORITY
+#    define TASK_SCHEDULER_ST7565_PRIORITY 0
+#endif
+#ifndef TASK_SCHEDULER_HAPTIC_PRIORITY
+#    define TASK_SCHEDULER_HAPTIC_PRIORITY 3
+#endif
+#ifndef TASK_SCHEDULER_BATTERY_PRIORITY
+#    define TASK_SCHEDULER_BATTERY_PRIORITY 0
+#endif
+#ifndef TASK_SCHEDULER_QUANTUM_PAINTER_PRIORITY
+#    define TASK_SCHEDULER_QUANTUM_PAINTER_PRIORITY 0
+#endif
+
+typedef struct scheduled_slot_t {
+    uint32_t deadline;
+    uint16_t period;
+    uint8_t  priority;
+    bool     released;
+} scheduled_slot_t;
+
+static scheduled_slot_t    slots[TASK_SCHEDULER_SLOT_COUNT];
+static deferred_executor_t release_executors[TASK_SCHEDULER_SLOT_COUNT] = {0};
+static uint32_t            last_release_check                           = 0;
+static uint16_t            granted                                      = 0;
+
+_Static_assert(TASK_SCHEDULER_SLOT_COUNT <= 16, "Too many scheduler slots for the grant mask");
+
+static uint32_t release_callback(uint32_t trigger_time, void *cb_arg) {
+    scheduled_slot_t *slot = (scheduled_slot_t *)cb_arg;
+    // If the task still hasn't run since its last release, keep the original (earlier) deadline
+    if (!slot->released) {
+        slot->released = true;
+        slot->deadline = trigger_time + slot->period;
+    }
+    return slot->period;
+}
+
+__attribute__((unused)) static void register_slot(task_scheduler_slot_t index, uint16_t period, uint8_t priority) {
+    scheduled_slot_t *slot = &slots[index];
+    slot->period           = period > 0 ? period : 1;
+    slot->priority         = priority;
+    slot->released         = true;
+    slot->deadline         = timer_read32();
+    defer_exec_advanced(release_executors, TASK_SCHEDULER_SLOT_COUNT, slot->period, release_callback, slot);
+}
+
+void task_scheduler_init(void) {
+#ifdef RGBLIGHT_ENABLE
+    register_slot(TASK_SCHEDULER_RGBLIGHT, TASK_SCHEDULER_RGBLIGHT_PERIOD, TASK_SCHEDULER_RGBLIGHT_PRIORITY);
+#endif
+#ifdef LED_MATRIX_ENABLE
+    register_slot(TASK_SCHEDULER_LED_MATRIX, TASK_SCHEDULER_LED_MATRIX_PERIOD, TASK_SCHEDULER_LED_MATRIX_PRIORITY);
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    register_slot(TASK_SCHEDULER_RGB_MATRIX, TASK_SCHEDULER_RGB_MATRIX_PERIOD, TASK_SCHEDULER_RGB_MATRIX_PRIORITY);
+#endif
+#if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    register_slot(TASK_SCHEDULER_BACKLIGHT, TASK_SCHEDULER_BACKLIGHT_PERIOD, TASK_SCHEDULER_BACKLIGHT_PRIORITY);
+#endif
+#ifdef OLED_ENABLE
+    register_slot(TASK_SCHEDULER_OLED, TASK_SCHEDULER_OLED_PERIOD, TASK_SCHEDULER_OLED_PRIORITY);
+#endif
+#ifdef ST7565_ENABLE
+    register_slot(TASK_SCHEDULER_ST7565, TASK_SCHEDULER_ST7565_PERIOD, TASK_SCHEDULER_ST7565_PRIORITY);
+#endif
+#ifdef HAPTIC_ENABLE
+    register_slot(TASK_SCHEDULER_HAPTIC, TASK_SCHEDULER_HAPTIC_PERIOD, TASK_SCHEDULER_HAPTIC_PRIORITY);
+#endif
+#ifdef BATTERY_DRIVER
+    register_slot(TASK_SCHEDULER_BATTERY, TASK_SCHEDULER_BATTERY_PERIOD, TASK_SCHEDULER_BATTERY_PRIORITY);
+#endif
+#ifdef QUANTUM_PAINTER_ENABLE
+    register_slot(TASK_SCHEDULER_QUANTUM_PAINTER, TASK_SCHEDULER_QUANTUM_PAINTER_PERIOD, TASK_SCHEDULER_QUANTUM_PAINTER_PRIORITY);
+#endif
+}
+
+static inline bool runs_before(const scheduled_slot_t *a, const scheduled_slot_t *b) {
+    int32_t diff = (int32_t)TIMER_DIFF_32(a->deadline, b->deadline);
+    return diff < 0 || (diff == 0 && a->priority > b->priority);
+}
+
+void task_scheduler_begin_iteration(bool input_pending) {
+    // Any grants left over from the previous iteration are for tasks that weren't reached, drop them
+    granted = 0;
+
+    deferred_exec_advanced_task(release_executors, TASK_SCHEDULER_SLOT_COUNT, &last_release_check);
+
+    // Key events take precedence, cosmetic tasks wait for an idle iteration
+    if (input_pending) {
+        return;
+    }
+
+    for (uint8_t n = 0; n < TASK_SCHEDULER_BUDGET; n++) {
+        int8_t best = -1;
+        for (uint8_t i = 0; i < TASK_SCHEDULER_SLOT_COUNT; i++) {
+            if (!slots[i].released || (granted & (1 << i))) {
+                continue;
+            }
+            if (best < 0 || runs_before(&slots[i], &slots[best])) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        granted |= (1 << best);
+    }
+}
+
+bool task_scheduler_should_run(task_scheduler_slot_t slot) {
+    if (granted & (1 << slot)) {
+        granted &= ~(1 << slot);
+        slots[slot].released = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,70 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+    Deadline-aware cooperative scheduling of cosmetic tasks.
+
+    Matrix scanning, keycode processing and report generation always run at the
+    start of every keyboard_task() iteration. Cosmetic tasks (lighting, displays,
+    haptics, battery sampling, Quantum Painter) are instead released by a
+    deferred_exec table at their configured period, and only get to run in the
+    remaining time of an iteration:
+
+      - no cosmetic task runs on an iteration which processed a matrix change,
+      - at most TASK_SCHEDULER_BUDGET released tasks run per iteration,
+      - released tasks are granted in earliest-deadline-first order, with the
+        configured priority used as a tie-breaker.
+
+    This bounds the worst-case key-to-report latency to one scan plus the
+    slowest TASK_SCHEDULER_BUDGET cosmetic tasks, regardless of how many
+    features are enabled.
+*/
+
+#ifndef TASK_SCHEDULER_BUDGET
+#    define TASK_SCHEDULER_BUDGET 1
+#endif
+
+typedef enum task_scheduler_slot_t {
+    TASK_SCHEDULER_RGBLIGHT,
+    TASK_SCHEDULER_LED_MATRIX,
+    TASK_SCHEDULER_RGB_MATRIX,
+    TASK_SCHEDULER_BACKLIGHT,
+    TASK_SCHEDULER_OLED,
+    TASK_SCHEDULER_ST7565,
+    TASK_SCHEDULER_HAPTIC,
+    TASK_SCHEDULER_BATTERY,
+    TASK_SCHEDULER_QUANTUM_PAINTER,
+    TASK_SCHEDULER_SLOT_COUNT,
+} task_scheduler_slot_t;
+
+#ifdef TASK_SCHEDULER_ENABLE
+
+/**
+ * \brief Registers the periodic release of all enabled cosmetic tasks. Invoked during keyboard_init().
+ */
+void task_scheduler_init(void);
+
+/**
+ * \brief Releases any cosmetic tasks whose period has elapsed, and grants this iteration's budget.
+ *
+ * \param input_pending true if this iteration handled a matrix change, in which case no cosmetic task is granted
+ */
+void task_scheduler_begin_iteration(bool input_pending);
+
+/**
+ * \brief Checks whether a cosmetic task was granted time in this iteration, consuming the grant if so.
+ */
+bool task_scheduler_should_run(task_scheduler_slot_t slot);
+
+#    define TASK_SCHEDULER_SHOULD_RUN(slot) task_scheduler_should_run(slot)
+
+#else
+
+#    define TASK_SCHEDULER_SHOULD_RUN(slot) true
+
+#endif // TASK_SCHEDULER_ENABLE
@@ -0,0 +1,210 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/*
+    Shared pieces of the host side matrix benchmarks.
+
+    A trace is a list of raw switch level changes, in milliseconds. Traces are
+    either generated from a fixed seed, so every run and every algorithm sees
+    the same input, or loaded from the CSV file named by the BENCHMARK_TRACE
+    environment variable, one "time_ms,row,col,pressed" line per change, for
+    replaying captures from real hardware.
+
+    Timings are wall clock nanoseconds, plus TSC cycles on x86. They are only
+    comparable between runs on the same machine, and are printed rather than
+    asserted on.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+struct BounceTraceEvent {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+};
+
+struct BounceTrace {
+    std::vector<BounceTraceEvent> events;
+    uint32_t                      duration = 0; // the last change, plus enough time for everything to settle
+    uint32_t                      presses  = 0; // key presses, each bounce train counts once
+};
+
+typedef std::vector<std::pair<uint8_t, uint8_t>> BenchmarkKeys; // (row, col)
+
+/* All positions of a rows by cols matrix */
+inline BenchmarkKeys benchmark_matrix_keys(uint8_t rows, uint8_t cols) {
+    BenchmarkKeys keys;
+    for (uint8_t row = 0; row < rows; row++) {
+        for (uint8_t col = 0; col < cols; col++) {
+            keys.emplace_back(row, col);
+        }
+    }
+    return keys;
+}
+
+/*
+    Typing on the given keys: a new key goes down every 40ms on average, is held
+    for 30 to 150ms, and is not pressed again for at least 20ms after release.
+    Every press and release is followed by up to max_bounces pairs of opposite
+    level changes, one millisecond apart, before settling.
+*/
+inline BounceTrace generate_bounce_trace(const BenchmarkKeys &keys, uint32_t duration_ms, uint8_t max_bounces, uint32_t seed = 0x9E3779B9) {
+    BounceTrace trace;
+    uint32_t    state = seed ? seed : 1;
+    auto        next  = [&state]() {
+        // xorshift32, the sequence must not depend on the standard library
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+
+    auto add_transition = [&](uint32_t time, uint8_t row, uint8_t col, bool pressed) {
+        uint8_t bounces = max_bounces ? next() % (max_bounces + 1) : 0;
+        for (uint8_t i = 0; i < bounces * 2; i++) {
+            trace.events.push_back({time + i, row, col, (i % 2 == 0) == pressed});
+        }
+        trace.events.push_back({time + bounces * 2, row, col, pressed});
+        return time + bounces * 2;
+    };
+
+    std::vector<uint32_t> release_at(keys.size(), 0);
+    std::vector<uint32_t> available_at(keys.size(), 0);
+    std::vector<bool>     held(keys.size(), false);
+    for (uint32_t time = 0; time < duration_ms; time++) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (held[i] && release_at[i] == time) {
+                available_at[i] = add_transition(time, keys[i].first, keys[i].second, false) + 20;
+                held[i]         = false;
+            }
+        }
+        if (next() % 40 == 0) {
+            size_t i = next() % keys.size();
+            if (!held[i] && available_at[i] <= time) {
+                uint32_t settled = add_transition(time, keys[i].first, keys[i].second, true);
+                release_at[i]    = settled + 30 + next() % 121;
+                held[i]          = true;
+                trace.presses++;
+            }
+        }
+    }
+    // Let everything still held go
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (held[i]) {
+            add_transition(std::max(release_at[i], duration_ms), keys[i].first, keys[i].second, false);
+        }
+    }
+
+    std::stable_sort(trace.events.begin(), trace.events.end(), [](const BounceTraceEvent &a, const BounceTraceEvent &b) { return a.time < b.time; });
+    trace.duration = (trace.events.empty() ? 0 : trace.events.back().time) + 100;
+    return trace;
+}
+
+/* Loads a "time_ms,row,col,pressed" CSV trace, lines that do not parse are skipped */
+inline bool load_bounce_trace(const char *path, uint8_t rows, uint8_t cols, BounceTrace &trace) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string           line;
+    std::vector<bool>     level(rows * cols, false);
+    std::vector<uint32_t> last_change(rows * cols, 0);
+    while (std::getline(file, line)) {
+        unsigned time, row, col, pressed;
+        if (std::sscanf(line.c_str(), "%u,%u,%u,%u", &time, &row, &col, &pressed) != 4 || row >= rows || col >= cols) {
+            continue;
+        }
+        // Without a reference, count a press for every rising edge after a settled release
+        size_t key = row * cols + col;
+        if (pressed && !level[key] && (last_change[key] == 0 || time - last_change[key] > 10)) {
+            trace.presses++;
+        }
+        level[key]       = pressed;
+        last_change[key] = time;
+        trace.events.push_back({time, (uint8_t)row, (uint8_t)col, pressed != 0});
+    }
+
+    std::stable_sort(trace.events.begin(), trace.events.end(), [](const BounceTraceEvent &a, const BounceTraceEvent &b) { return a.time < b.time; });
+    trace.duration = (trace.events.empty() ? 0 : trace.events.back().time) + 100;
+    return true;
+}
+
+/* The trace named by BENCHMARK_TRACE if set, a generated one otherwise */
+inline BounceTrace benchmark_trace(const BenchmarkKeys &keys, uint8_t rows, uint8_t cols, uint32_t duration_ms, uint8_t max_bounces, bool *recorded = nullptr) {
+    BounceTrace trace;
+    const char *path = std::getenv("BENCHMARK_TRACE");
+    bool        used = path && load_bounce_trace(path, rows, cols, trace);
+    if (recorded) {
+        *recorded = used;
+    }
+    return used ? trace : generate_bounce_trace(keys, duration_ms, max_bounces);
+}
+
+inline uint64_t benchmark_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Measures the best of several runs, the minimum is the least disturbed by the rest of the machine */
+class BenchmarkTimer {
+   public:
+    void start() {
+        start_cycles_ = benchmark_cycles();
+        start_        = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        auto     end    = std::chrono::steady_clock::now();
+        uint64_t cycles = benchmark_cycles() - start_cycles_;
+        uint64_t ns     = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+        if (runs_ == 0 || ns < best_ns_) {
+            best_ns_     = ns;
+            best_cycles_ = cycles;
+        }
+        runs_++;
+    }
+
+    uint64_t ns() const {
+        return best_ns_;
+    }
+
+    uint64_t cycles() const {
+        return best_cycles_;
+    }
+
+   private:
+    std::chrono::steady_clock::time_point start_;
+    uint64_t                              start_cycles_ = 0;
+    uint64_t                              best_ns_      = 0;
+    uint64_t                              best_cycles_  = 0;
+    unsigned                              runs_         = 0;
+};
+
+inline void benchmark_report(const char *name, const char *variant, uint8_t rows, uint8_t cols, uint32_t scans, uint32_t events, const BenchmarkTimer &timer) {
+    std::ostringstream line;
+    line << "[ BENCH    ] " << name << " " << variant << " " << +rows << "x" << +cols << ": " << scans << " scans, " << events << " events, " << (double)timer.ns() / scans << " ns/scan, " << (events ? (double)timer.ns() / events : 0.0) << " ns/event";
+    if (timer.cycles()) {
+        line << ", " << (double)timer.cycles() / scans << " cycles/scan, " << (events ? (double)timer.cycles() / events : 0.0) << " cycles/event";
+    }
+    std::printf("%s\n", line.str().c_str());
+}
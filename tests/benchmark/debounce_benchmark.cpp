@@ -0,0 +1,111 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+    Replays a bounce trace through the debounce algorithm this binary is built
+    with, once per matrix size, one debounce() call per millisecond as a
+    keyboard scanning at 1kHz would. Reports the time per scan and per cooked
+    key change, and checks that the algorithm removed the bounces.
+*/
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+#include "benchmark_common.hpp"
+
+extern "C" {
+#include "matrix.h"
+#include "timer.h"
+#include "debounce.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define BENCHMARK_STR(x) #x
+#define BENCHMARK_XSTR(x) BENCHMARK_STR(x)
+
+// Bounce trains last at most 2 * BENCHMARK_MAX_BOUNCES milliseconds, below DEBOUNCE
+#define BENCHMARK_MAX_BOUNCES 2
+#define BENCHMARK_DURATION 60000
+#define BENCHMARK_RUNS 5
+
+class DebounceBenchmark : public ::testing::TestWithParam<uint8_t> {};
+
+TEST_P(DebounceBenchmark, ReplayTrace) {
+    const uint8_t rows = GetParam();
+    const uint8_t cols = MATRIX_COLS;
+    ASSERT_LE(rows, MATRIX_ROWS);
+
+    bool        recorded = false;
+    BounceTrace trace    = benchmark_trace(benchmark_matrix_keys(rows, cols), rows, cols, BENCHMARK_DURATION, BENCHMARK_MAX_BOUNCES, &recorded);
+    ASSERT_FALSE(trace.events.empty());
+
+    // Precompute the raw matrix of every scan, so only debounce() is timed
+    std::vector<matrix_row_t> frames(trace.duration * rows, 0);
+    std::vector<bool>         changed(trace.duration, false);
+    std::vector<matrix_row_t> raw(rows, 0);
+    size_t                    next_event = 0;
+    for (uint32_t time = 0; time < trace.duration; time++) {
+        for (; next_event < trace.events.size() && trace.events[next_event].time <= time; next_event++) {
+            const BounceTraceEvent &event = trace.events[next_event];
+            matrix_row_t            mask  = MATRIX_ROW_SHIFTER << event.col;
+            matrix_row_t            row   = event.pressed ? raw[event.row] | mask : raw[event.row] & ~mask;
+            changed[time]                 = changed[time] || row != raw[event.row];
+            raw[event.row]                = row;
+        }
+        memcpy(&frames[time * rows], raw.data(), rows * sizeof(matrix_row_t));
+    }
+
+    std::vector<matrix_row_t> input(rows);
+    std::vector<matrix_row_t> cooked(rows);
+    BenchmarkTimer            timer;
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        std::fill(cooked.begin(), cooked.end(), 0);
+        set_time(0);
+        debounce_init(rows);
+
+        timer.start();
+        for (uint32_t time = 0; time < trace.duration; time++) {
+            // Algorithms may write to the raw matrix, like matrix.c they get a copy
+            memcpy(input.data(), &frames[time * rows], rows * sizeof(matrix_row_t));
+            debounce(input.data(), cooked.data(), rows, changed[time]);
+            advance_time(1);
+        }
+        timer.stop();
+        debounce_free();
+    }
+
+    // A last, untimed pass counts the cooked changes
+    std::vector<matrix_row_t> previous(rows, 0);
+    uint32_t                  events  = 0;
+    uint32_t                  presses = 0;
+    std::fill(cooked.begin(), cooked.end(), 0);
+    set_time(0);
+    debounce_init(rows);
+    for (uint32_t time = 0; time < trace.duration; time++) {
+        memcpy(input.data(), &frames[time * rows], rows * sizeof(matrix_row_t));
+        debounce(input.data(), cooked.data(), rows, changed[time]);
+        for (uint8_t row = 0; row < rows; row++) {
+            matrix_row_t diff = cooked[row] ^ previous[row];
+            events += __builtin_popcountll(diff);
+            presses += __builtin_popcountll(diff & cooked[row]);
+            previous[row] = cooked[row];
+        }
+        advance_time(1);
+    }
+    debounce_free();
+
+    benchmark_report("debounce", BENCHMARK_XSTR(DEBOUNCE_ALGORITHM), rows, cols, trace.duration, events, timer);
+
+    for (uint8_t row = 0; row < rows; row++) {
+        EXPECT_EQ(cooked[row], 0) << "row " << +row << " still has keys down after the trace settled";
+    }
+    // Only the generated traces are known to bounce for less than DEBOUNCE
+    if (!recorded && strcmp(BENCHMARK_XSTR(DEBOUNCE_ALGORITHM), "none") != 0) {
+        EXPECT_EQ(presses, trace.presses);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(MatrixSizes, DebounceBenchmark, ::testing::Values(4, 8, 16), [](const ::testing::TestParamInfo<uint8_t> &info) { return "Rows" + std::to_string(info.param); });
@@ -0,0 +1,84 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/*
+    Replays a trace through keyboard_task(), one call per millisecond, with the
+    features of the including test directory enabled. The test matrix has no
+    real debouncing to do, so the trace is bounce free and every change in it
+    is a key event that reaches the keymap.
+
+    Keys are spread evenly over the matrix, so the keymap lookups of the test
+    fixture cost the same whatever the matrix size, and the differences come
+    from the scan itself.
+*/
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "benchmark_common.hpp"
+
+extern "C" {
+#include "keyboard.h"
+#include "test_matrix.h"
+
+void advance_time(uint32_t ms);
+}
+
+#define MATRIX_TASK_BENCHMARK_KEYS 40
+#define MATRIX_TASK_BENCHMARK_DURATION 20000
+#define MATRIX_TASK_BENCHMARK_RUNS 3
+
+class MatrixTaskBenchmark : public TestFixture {
+   protected:
+    /* Maps the keys the trace presses, and returns them */
+    BenchmarkKeys map_keys() {
+        BenchmarkKeys keys;
+        uint16_t      count = MATRIX_ROWS * MATRIX_COLS;
+        uint16_t      step  = count > MATRIX_TASK_BENCHMARK_KEYS ? count / MATRIX_TASK_BENCHMARK_KEYS : 1;
+        for (uint16_t i = 0; i < count && keys.size() < MATRIX_TASK_BENCHMARK_KEYS; i += step) {
+            uint8_t row = i / MATRIX_COLS;
+            uint8_t col = i % MATRIX_COLS;
+            add_key(KeymapKey{0, col, row, (uint16_t)(KC_A + keys.size() % 26)});
+            keys.emplace_back(row, col);
+        }
+        return keys;
+    }
+
+    void run(const char *variant) {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(testing::_)).Times(testing::AnyNumber());
+
+        BenchmarkKeys keys  = map_keys();
+        BounceTrace   trace = generate_bounce_trace(keys, MATRIX_TASK_BENCHMARK_DURATION, 0);
+        ASSERT_FALSE(trace.events.empty());
+
+        BenchmarkTimer timer;
+        for (int run = 0; run < MATRIX_TASK_BENCHMARK_RUNS; run++) {
+            size_t next_event = 0;
+
+            timer.start();
+            for (uint32_t time = 0; time < trace.duration; time++) {
+                for (; next_event < trace.events.size() && trace.events[next_event].time <= time; next_event++) {
+                    const BounceTraceEvent &event = trace.events[next_event];
+                    if (event.pressed) {
+                        press_key(event.col, event.row);
+                    } else {
+                        release_key(event.col, event.row);
+                    }
+                }
+                keyboard_task();
+                advance_time(1);
+            }
+            timer.stop();
+        }
+
+        benchmark_report("matrix_task", variant, MATRIX_ROWS, MATRIX_COLS, trace.duration, trace.events.size(), timer);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+};
@@ -0,0 +1,8 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "../matrix_task_benchmark.hpp"
+
+TEST_F(MatrixTaskBenchmark, default) {
+    run("default");
+}
@@ -0,0 +1,14 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "../matrix_task_benchmark.hpp"
+
+/* Ghost detection looks up every position of the base layer, the benchmark maps all of them */
+extern "C" uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return layer_num == 0 ? KC_A : KC_NO;
+}
+
+TEST_F(MatrixTaskBenchmark, ghost) {
+    matrix_ghost_cache_invalidate();
+    run("ghost");
+}
@@ -0,0 +1,11 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#undef MATRIX_ROWS
+#undef MATRIX_COLS
+#define MATRIX_ROWS 16
+#define MATRIX_COLS 32
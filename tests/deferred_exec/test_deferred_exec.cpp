@@ -0,0 +1,192 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+class DeferredExec : public TestFixture {};
+
+struct fired_t {
+    uint32_t trigger_time;
+    uint32_t now;
+};
+
+static std::vector<fired_t> fired;
+
+static uint32_t record_callback(uint32_t trigger_time, void *cb_arg) {
+    fired.push_back({trigger_time, timer_read32()});
+    return cb_arg ? *(uint32_t *)cb_arg : 0;
+}
+
+static void run_for(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        advance_time(1);
+        deferred_exec_task();
+    }
+}
+
+TEST_F(DeferredExec, fires_exactly_on_time_across_wheel_levels) {
+    const uint32_t delays[] = {1, 15, 16, 17, 255, 256, 300, 4096, 5000, 70000};
+    fired.clear();
+    deferred_exec_task();
+
+    uint32_t start = timer_read32();
+    for (uint32_t delay : delays) {
+        EXPECT_NE(defer_exec(delay, record_callback, NULL), INVALID_DEFERRED_TOKEN);
+    }
+
+    run_for(70001);
+    ASSERT_EQ(fired.size(), sizeof(delays) / sizeof(delays[0]));
+    for (size_t i = 0; i < fired.size(); i++) {
+        EXPECT_EQ(fired[i].trigger_time, start + delays[i]);
+        EXPECT_EQ(fired[i].now, start + delays[i]);
+    }
+}
+
+TEST_F(DeferredExec, repeats_relative_to_previous_trigger) {
+    static uint32_t period = 7;
+    fired.clear();
+    deferred_exec_task();
+
+    uint32_t       start = timer_read32();
+    deferred_token token = defer_exec(period, record_callback, &period);
+    run_for(70);
+    EXPECT_TRUE(cancel_deferred_exec(token));
+
+    ASSERT_EQ(fired.size(), 10u);
+    for (size_t i = 0; i < fired.size(); i++) {
+        EXPECT_EQ(fired[i].trigger_time, start + period * (i + 1));
+    }
+}
+
+TEST_F(DeferredExec, cancel_and_extend) {
+    fired.clear();
+    deferred_exec_task();
+
+    uint32_t       start     = timer_read32();
+    deferred_token cancelled = defer_exec(50, record_callback, NULL);
+    deferred_token extended  = defer_exec(50, record_callback, NULL);
+
+    run_for(10);
+    EXPECT_TRUE(cancel_deferred_exec(cancelled));
+    EXPECT_FALSE(cancel_deferred_exec(cancelled));
+    EXPECT_FALSE(extend_deferred_exec(cancelled, 10));
+    EXPECT_TRUE(extend_deferred_exec(extended, 100));
+
+    // The cancelled slot is reused, but with a different token
+    deferred_token reused = defer_exec(500, record_callback, NULL);
+    EXPECT_NE(reused, cancelled);
+    EXPECT_FALSE(cancel_deferred_exec(cancelled));
+
+    run_for(200);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].trigger_time, start + 110);
+    EXPECT_TRUE(cancel_deferred_exec(reused));
+}
+
+TEST_F(DeferredExec, catches_up_after_a_stall) {
+    fired.clear();
+    deferred_exec_task();
+
+    uint32_t start = timer_read32();
+    defer_exec(3, record_callback, NULL);
+    defer_exec(1000, record_callback, NULL);
+    defer_exec(20000, record_callback, NULL);
+
+    advance_time(1500);
+    deferred_exec_task();
+    ASSERT_EQ(fired.size(), 2u);
+    EXPECT_EQ(fired[0].trigger_time, start + 3);
+    EXPECT_EQ(fired[1].trigger_time, start + 1000);
+
+    run_for(18500);
+    ASSERT_EQ(fired.size(), 3u);
+    EXPECT_EQ(fired[2].now, start + 20000);
+}
+
+TEST_F(DeferredExec, repeating_executor_does_not_burst_after_a_stall) {
+    static uint32_t period = 10;
+    fired.clear();
+    deferred_exec_task();
+
+    uint32_t       start = timer_read32();
+    deferred_token token = defer_exec(period, record_callback, &period);
+
+    // Ten periods are missed, but only one invocation is made up for
+    advance_time(105);
+    deferred_exec_task();
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].trigger_time, start + 10);
+
+    // Repeats resume from the current time
+    run_for(11);
+    EXPECT_TRUE(cancel_deferred_exec(token));
+    ASSERT_EQ(fired.size(), 3u);
+    EXPECT_EQ(fired[1].trigger_time, start + 106);
+    EXPECT_EQ(fired[1].now, start + 106);
+    EXPECT_EQ(fired[2].trigger_time, start + 116);
+}
+
+TEST_F(DeferredExec, advanced_repeating_executor_catches_up_after_a_stall) {
+    static uint32_t     period              = 10;
+    deferred_executor_t table[2]            = {};
+    uint32_t            last_execution_time = 0;
+    fired.clear();
+
+    uint32_t       start = timer_read32();
+    deferred_token token = defer_exec_advanced(table, 2, period, record_callback, &period);
+
+    // Missed repeats are made up for, one per pass, keeping their intended trigger times
+    advance_time(35);
+    deferred_exec_advanced_task(table, 2, &last_execution_time);
+    ASSERT_EQ(fired.size(), 1u);
+    advance_time(1);
+    deferred_exec_advanced_task(table, 2, &last_execution_time);
+    advance_time(1);
+    deferred_exec_advanced_task(table, 2, &last_execution_time);
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, 2, token));
+    ASSERT_EQ(fired.size(), 3u);
+    EXPECT_EQ(fired[0].trigger_time, start + 10);
+    EXPECT_EQ(fired[1].trigger_time, start + 20);
+    EXPECT_EQ(fired[2].trigger_time, start + 30);
+    EXPECT_EQ(fired[2].now, start + 37);
+}
+
+TEST_F(DeferredExec, capacity_and_next_deadline) {
+    fired.clear();
+    deferred_exec_task();
+
+    uint32_t deadline;
+    EXPECT_FALSE(deferred_exec_next_deadline(&deadline));
+
+    uint32_t                    start = timer_read32();
+    std::vector<deferred_token> tokens;
+    for (uint32_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        tokens.push_back(defer_exec(1000 + i * 37, record_callback, NULL));
+        EXPECT_NE(tokens.back(), INVALID_DEFERRED_TOKEN);
+    }
+    EXPECT_EQ(defer_exec(10, record_callback, NULL), INVALID_DEFERRED_TOKEN);
+
+    // The reported deadline may be early, but must never be late
+    size_t expected = 0;
+    while (expected < MAX_DEFERRED_EXECUTORS) {
+        ASSERT_TRUE(deferred_exec_next_deadline(&deadline));
+        uint32_t due = start + 1000 + expected * 37;
+        ASSERT_LE((int32_t)TIMER_DIFF_32(deadline, due), 0);
+        advance_time(TIMER_DIFF_32(deadline, timer_read32()));
+        deferred_exec_task();
+        if (fired.size() > expected) {
+            EXPECT_EQ(fired.back().now, due);
+            expected++;
+        }
+    }
+    EXPECT_FALSE(deferred_exec_next_deadline(&deadline));
+}
@@ -0,0 +1,12 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// Enough room for eeconfig plus the dynamic keymap and macros
+#define TOTAL_EEPROM_BYTE_COUNT 1024
+#define DYNAMIC_KEYMAP_LAYER_COUNT 2
+#define DYNAMIC_KEYMAP_RAM_MIRROR
+#define DYNAMIC_KEYMAP_RAM_MIRROR_FLUSH_DELAY 100
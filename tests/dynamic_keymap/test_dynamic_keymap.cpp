@@ -0,0 +1,59 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "nvm_dynamic_keymap.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+class DynamicKeymap : public TestFixture {};
+
+TEST_F(DynamicKeymap, writes_are_coalesced_until_quiet) {
+    dynamic_keymap_reset();
+    uint16_t original = nvm_dynamic_keymap_read_keycode(1, 0, 0);
+
+    dynamic_keymap_set_keycode(1, 0, 0, KC_A);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 0), KC_A);
+    EXPECT_EQ(nvm_dynamic_keymap_read_keycode(1, 0, 0), original);
+
+    // Further writes keep pushing the write-back out
+    advance_time(60);
+    dynamic_keymap_task();
+    dynamic_keymap_set_keycode(1, 0, 0, KC_B);
+    advance_time(60);
+    dynamic_keymap_task();
+    EXPECT_EQ(nvm_dynamic_keymap_read_keycode(1, 0, 0), original);
+
+    advance_time(40);
+    dynamic_keymap_task();
+    EXPECT_EQ(nvm_dynamic_keymap_read_keycode(1, 0, 0), KC_B);
+}
+
+TEST_F(DynamicKeymap, buffer_round_trips_through_mirror) {
+    dynamic_keymap_reset();
+
+    uint8_t write[] = {0x12, 0x34, 0x56, 0x78};
+    // Odd offset, straddling two keycodes
+    dynamic_keymap_set_buffer(1, 3, write);
+    dynamic_keymap_set_buffer(4, 1, &write[3]);
+
+    uint8_t read[6] = {0};
+    dynamic_keymap_get_buffer(0, sizeof(read), read);
+    uint8_t nvm[6] = {0};
+    nvm_dynamic_keymap_read_buffer(0, sizeof(nvm), nvm);
+    EXPECT_EQ(read[1], 0x12);
+    EXPECT_EQ(read[2], 0x34);
+    EXPECT_EQ(read[3], 0x56);
+    EXPECT_EQ(read[4], 0x78);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), 0x3456);
+
+    dynamic_keymap_flush();
+    nvm_dynamic_keymap_read_buffer(0, sizeof(nvm), nvm);
+    EXPECT_EQ(memcmp(read, nvm, sizeof(read)), 0);
+}
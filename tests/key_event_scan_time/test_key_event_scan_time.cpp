@@ -0,0 +1,53 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == KC_B && record->event.pressed) {
+        // Simulate a slow handler, long enough to exceed the tapping term on its own
+        wait_ms(TAPPING_TERM + 10);
+    }
+    return true;
+}
+} // extern "C"
+
+using testing::_;
+using testing::InSequence;
+
+class KeyEventScanTime : public TestFixture {};
+
+TEST_F(KeyEventScanTime, mod_tap_uses_scan_time_despite_slow_handler) {
+    TestDriver driver;
+    InSequence s;
+    auto       slow_key         = KeymapKey(0, 0, 0, KC_B);
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({slow_key, mod_tap_hold_key});
+
+    /* Press both keys in the same scan, the slow key is processed first. */
+    EXPECT_REPORT(driver, (KC_B));
+    slow_key.press();
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap-hold key, it was physically held for longer than the tapping term. */
+    EXPECT_REPORT(driver, (KC_B, KC_LSFT));
+    EXPECT_REPORT(driver, (KC_B));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release slow key. */
+    EXPECT_EMPTY_REPORT(driver);
+    slow_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
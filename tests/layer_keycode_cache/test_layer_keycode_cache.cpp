@@ -0,0 +1,108 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerKeycodeCache : public TestFixture {};
+
+TEST_F(LayerKeycodeCache, follows_layer_changes_through_transparent_keys) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_c = KeymapKey{2, 1, 0, KC_C};
+
+    set_keymap({key_a, KeymapKey{1, 1, 0, KC_TRNS}, key_c});
+    layer_keycode_cache_invalidate();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Layer 1 is transparent at this position */
+    layer_on(1);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Enabling a higher layer must replace the cached keycode */
+    layer_on(2);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_c);
+    VERIFY_AND_CLEAR(driver);
+
+    /* As must disabling the layer it was resolved from */
+    layer_off(2);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    layer_clear();
+}
+
+TEST_F(LayerKeycodeCache, held_key_releases_from_its_press_layer) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  layer_key = KeymapKey{0, 0, 0, MO(1)};
+    KeymapKey  key_a     = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_b     = KeymapKey{1, 1, 0, KC_B};
+
+    set_keymap({layer_key, KeymapKey{1, 0, 0, KC_TRNS}, key_a, key_b});
+    layer_keycode_cache_invalidate();
+
+    layer_key.press();
+    run_one_scan_loop();
+
+    EXPECT_REPORT(driver, (KC_B));
+    key_b.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Leaving the layer while B is held must not turn its release into an A release */
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* And the next press resolves on the base layer again */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerKeycodeCache, invalidate_picks_up_keymap_changes) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_d = KeymapKey{0, 1, 0, KC_D};
+
+    set_keymap({key_a});
+    layer_keycode_cache_invalidate();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    set_keymap({key_d});
+    layer_keycode_cache_invalidate();
+
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_d);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,78 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_layer.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerState64Bit : public TestFixture {};
+
+TEST_F(LayerState64Bit, highest_layer) {
+    EXPECT_EQ(MAX_LAYER, 64);
+    EXPECT_EQ(get_highest_layer((layer_state_t)0), 0);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1), 0);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 31), 31);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 32 | 1), 32);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 47 | (layer_state_t)1 << 40), 47);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 63 | 0xFF), 63);
+}
+
+TEST_F(LayerState64Bit, layers_above_32_resolve_through_transparent_keys) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_b = KeymapKey{33, 1, 0, KC_B};
+    KeymapKey  key_c = KeymapKey{63, 1, 0, KC_C};
+
+    set_keymap({key_a, key_b, KeymapKey{40, 1, 0, KC_TRNS}, key_c});
+
+    layer_on(33);
+    layer_on(40);
+    EXPECT_TRUE(layer_state_is(40));
+    EXPECT_EQ(get_highest_layer(layer_state), 40);
+
+    /* Layer 40 is transparent at this position */
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+
+    layer_on(63);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_c);
+    VERIFY_AND_CLEAR(driver);
+
+    layer_clear();
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerState64Bit, held_key_releases_from_its_press_layer) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_a = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_b = KeymapKey{45, 1, 0, KC_B};
+
+    set_keymap({key_a, key_b});
+
+    layer_on(45);
+    EXPECT_REPORT(driver, (KC_B));
+    key_b.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The release comes from layer 45, which is looked up in the source layers cache */
+    layer_off(45);
+    EXPECT_EMPTY_REPORT(driver);
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
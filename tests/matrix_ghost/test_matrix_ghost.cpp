@@ -0,0 +1,170 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+/* Ghost detection looks up every position of the base layer through the keymap introspection */
+static uint16_t base_layer[MATRIX_ROWS][MATRIX_COLS];
+
+extern "C" uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return layer_num == 0 ? base_layer[row][column] : KC_NO;
+}
+
+class MatrixGhost : public TestFixture {
+   protected:
+    void set_base_layer(std::initializer_list<KeymapKey> keys) {
+        set_keymap(keys);
+        memset(base_layer, 0, sizeof(base_layer));
+        for (const auto &key : keys) {
+            base_layer[key.position.row][key.position.col] = key.code;
+        }
+        matrix_ghost_cache_invalidate();
+    }
+};
+
+TEST_F(MatrixGhost, row_completing_a_rectangle_is_ignored) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey{0, 0, 0, KC_A};
+    KeymapKey  key_b = KeymapKey{0, 1, 0, KC_B};
+    KeymapKey  key_c = KeymapKey{0, 0, 1, KC_C};
+    KeymapKey  key_d = KeymapKey{0, 1, 1, KC_D};
+
+    set_base_layer({key_a, key_b, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    key_a.press();
+    run_one_scan_loop();
+    key_c.press();
+    run_one_scan_loop();
+    /* Only one column is shared with the other row */
+    key_b.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* D shares both columns with the first row, so it could be a ghost */
+    EXPECT_NO_REPORT(driver);
+    key_d.press();
+    run_one_scan_loop();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Once the first row no longer forms a rectangle, D is accepted */
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_C, KC_D));
+    key_b.release();
+    run_one_scan_loop();
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    key_c.release();
+    run_one_scan_loop();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixGhost, blank_positions_do_not_form_a_rectangle) {
+    TestDriver driver;
+    KeymapKey  key_a     = KeymapKey{0, 0, 0, KC_A};
+    KeymapKey  key_blank = KeymapKey{0, 1, 0, KC_NO};
+    KeymapKey  key_c     = KeymapKey{0, 0, 1, KC_C};
+    KeymapKey  key_d     = KeymapKey{0, 1, 1, KC_D};
+
+    set_base_layer({key_a, key_blank, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_C, KC_D));
+    key_a.press();
+    run_one_scan_loop();
+    key_blank.press();
+    run_one_scan_loop();
+    key_c.press();
+    run_one_scan_loop();
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_blank.release();
+    run_one_scan_loop();
+    key_c.release();
+    run_one_scan_loop();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixGhost, invalidate_picks_up_keymap_changes) {
+    TestDriver driver;
+    KeymapKey  key_a     = KeymapKey{0, 0, 0, KC_A};
+    KeymapKey  key_blank = KeymapKey{0, 1, 0, KC_NO};
+    KeymapKey  key_b     = KeymapKey{0, 1, 0, KC_B};
+    KeymapKey  key_c     = KeymapKey{0, 0, 1, KC_C};
+    KeymapKey  key_d     = KeymapKey{0, 1, 1, KC_D};
+
+    set_base_layer({key_a, key_blank, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_C, KC_D));
+    key_a.press();
+    key_blank.press();
+    run_one_scan_loop();
+    key_c.press();
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_blank.release();
+    run_one_scan_loop();
+    key_c.release();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The blank position becomes a real key, and now completes the rectangle */
+    set_base_layer({key_a, key_b, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    key_a.press();
+    key_b.press();
+    run_one_scan_loop();
+    key_c.press();
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
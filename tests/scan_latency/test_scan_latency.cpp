@@ -0,0 +1,102 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "scan_latency.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class ScanLatency : public TestFixture {
+   protected:
+    void SetUp() override {
+        scan_latency_reset();
+    }
+};
+
+TEST_F(ScanLatency, records_scan_interval) {
+    TestDriver           driver;
+    scan_latency_stats_t stats;
+
+    EXPECT_FALSE(scan_latency_get_stats(SCAN_LATENCY_SCAN_INTERVAL, &stats));
+
+    /* Every test scan loop advances the timer by a millisecond */
+    idle_for(100);
+    ASSERT_TRUE(scan_latency_get_stats(SCAN_LATENCY_SCAN_INTERVAL, &stats));
+    EXPECT_EQ(stats.samples, 99);
+    EXPECT_EQ(stats.p50, 1000);
+    EXPECT_EQ(stats.p99, 1000);
+    EXPECT_EQ(stats.max, 1000);
+
+    uint32_t upper_us;
+    EXPECT_EQ(scan_latency_get_bucket(SCAN_LATENCY_SCAN_INTERVAL, 12, &upper_us), 99);
+    EXPECT_EQ(upper_us, 1000);
+}
+
+TEST_F(ScanLatency, records_key_to_report_latency) {
+    TestDriver           driver;
+    scan_latency_stats_t stats;
+    KeymapKey            key_a = KeymapKey{0, 0, 0, KC_A};
+    KeymapKey            key_b = KeymapKey{0, 1, 0, SFT_T(KC_B)};
+
+    set_keymap({key_a, key_b});
+
+    /* A plain key is reported in the same scan that found it */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_TRUE(scan_latency_get_stats(SCAN_LATENCY_KEY_TO_REPORT, &stats));
+    EXPECT_EQ(stats.samples, 2);
+    EXPECT_EQ(stats.max, 0);
+
+    /* A held mod-tap is only reported by a later scan once the tapping term has passed, so it is not sampled */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    key_b.press();
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_TRUE(scan_latency_get_stats(SCAN_LATENCY_KEY_TO_REPORT, &stats));
+    EXPECT_EQ(stats.samples, 2);
+
+    /* Its release is reported in the same scan */
+    EXPECT_EMPTY_REPORT(driver);
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_TRUE(scan_latency_get_stats(SCAN_LATENCY_KEY_TO_REPORT, &stats));
+    EXPECT_EQ(stats.samples, 3);
+    EXPECT_EQ(stats.max, 0);
+}
+
+TEST_F(ScanLatency, answers_raw_hid_queries) {
+    TestDriver driver;
+    uint8_t    data[32] = {SCAN_LATENCY_RAW_HID_ID, SCAN_LATENCY_SCAN_INTERVAL};
+
+    idle_for(11);
+    ASSERT_TRUE(scan_latency_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[0], SCAN_LATENCY_RAW_HID_ID);
+    EXPECT_EQ(data[1], SCAN_LATENCY_SCAN_INTERVAL);
+    EXPECT_EQ(data[2], SCAN_LATENCY_HISTOGRAM_COUNT);
+    EXPECT_EQ(data[6], 10);                    // samples
+    EXPECT_EQ(data[9] << 8 | data[10], 1000); // p50
+
+    /* Other reports are left alone */
+    data[0] = SCAN_LATENCY_RAW_HID_ID + 1;
+    EXPECT_FALSE(scan_latency_raw_hid_receive(data, sizeof(data)));
+
+    scan_latency_stats_t stats;
+    data[0] = SCAN_LATENCY_RAW_HID_ID;
+    data[1] = 0xFF;
+    ASSERT_TRUE(scan_latency_raw_hid_receive(data, sizeof(data)));
+    EXPECT_FALSE(scan_latency_get_stats(SCAN_LATENCY_SCAN_INTERVAL, &stats));
+}
@@ -0,0 +1,10 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define SOURCE_LAYERS_CACHE_TABLE
+// Small enough for keys to share home slots
+#define SOURCE_LAYERS_CACHE_TABLE_SIZE 4
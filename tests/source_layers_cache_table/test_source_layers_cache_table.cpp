@@ -0,0 +1,174 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_layer.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class SourceLayersCacheTable : public TestFixture {};
+
+TEST_F(SourceLayersCacheTable, held_key_releases_from_its_press_layer) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  layer_key = KeymapKey{0, 0, 0, MO(1)};
+    KeymapKey  key_a     = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_b     = KeymapKey{1, 1, 0, KC_B};
+
+    set_keymap({layer_key, KeymapKey{1, 0, 0, KC_TRNS}, key_a, key_b});
+
+    layer_key.press();
+    run_one_scan_loop();
+
+    EXPECT_REPORT(driver, (KC_B));
+    key_b.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SourceLayersCacheTable, released_keys_free_their_slots) {
+    TestDriver             driver;
+    InSequence             s;
+    KeymapKey              layer_key = KeymapKey{0, 0, 0, MO(1)};
+    std::vector<KeymapKey> keys;
+
+    set_keymap({layer_key, KeymapKey{1, 0, 0, KC_TRNS}});
+
+    // Many more keys than slots, pressed on layer 1 and released on layer 0
+    for (uint8_t i = 0; i < 12; i++) {
+        uint8_t col = 1 + i % (MATRIX_COLS - 1), row = i / (MATRIX_COLS - 1);
+        keys.push_back(KeymapKey{1, col, row, (uint16_t)(KC_A + i)});
+        add_key(keys.back());
+        add_key(KeymapKey{0, col, row, KC_NO});
+    }
+
+    // Keep one key held throughout, so that later keys collide with it
+    layer_key.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (keys[0].report_code));
+    keys[0].press();
+    run_one_scan_loop();
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    for (size_t i = 1; i < keys.size(); i++) {
+        layer_key.press();
+        run_one_scan_loop();
+
+        EXPECT_REPORT(driver, (keys[0].report_code, keys[i].report_code));
+        keys[i].press();
+        run_one_scan_loop();
+        VERIFY_AND_CLEAR(driver);
+
+        EXPECT_REPORT(driver, (keys[0].report_code));
+        layer_key.release();
+        run_one_scan_loop();
+        keys[i].release();
+        run_one_scan_loop();
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    EXPECT_EMPTY_REPORT(driver);
+    keys[0].release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SourceLayersCacheTable, release_uses_the_action_of_the_press) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_a = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  key_d = KeymapKey{0, 1, 0, KC_D};
+
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The keymap changes while A is held, as with a dynamic keymap update
+    set_keymap({key_d});
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SourceLayersCacheTable, more_held_keys_than_slots_release_from_their_press_layer) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  layer_key = KeymapKey{0, 0, 0, MO(1)};
+    KeymapKey  key_a     = KeymapKey{1, 1, 0, KC_A};
+    KeymapKey  key_b     = KeymapKey{1, 2, 0, KC_B};
+    KeymapKey  key_c     = KeymapKey{1, 3, 0, KC_C};
+    KeymapKey  key_d     = KeymapKey{1, 0, 1, KC_D};
+    KeymapKey  key_e     = KeymapKey{1, 1, 1, KC_E};
+
+    set_keymap({layer_key, KeymapKey{1, 0, 0, KC_TRNS}, key_a, key_b, key_c, key_d, key_e, KeymapKey{0, 1, 0, KC_NO}, KeymapKey{0, 2, 0, KC_NO}, KeymapKey{0, 3, 0, KC_NO}, KeymapKey{0, 0, 1, KC_NO}, KeymapKey{0, 1, 1, KC_NO}});
+
+    // The layer key and five more keys are held at once, with only four slots
+    layer_key.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    key_b.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    key_c.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D));
+    key_d.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E));
+    key_e.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // Every key still releases what it pressed on layer 1
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E));
+    key_a.release();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_C, KC_D, KC_E));
+    key_b.release();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_D, KC_E));
+    key_c.release();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_E));
+    key_d.release();
+    run_one_scan_loop();
+    EXPECT_EMPTY_REPORT(driver);
+    key_e.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,238 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class PredictiveTapHold : public TestFixture {
+   public:
+    PredictiveTapHold() {
+        predictive_tap_hold_reset();
+    }
+
+   protected:
+    const predictive_tap_hold_stats_t *stats_for(const KeymapKey &key) {
+        uint8_t                            count;
+        const predictive_tap_hold_stats_t *stats = predictive_tap_hold_get_stats(&count);
+        for (uint8_t i = 0; i < count; i++) {
+            if (KEYEQ(stats[i].key, key.position)) {
+                return &stats[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void train_taps(TestDriver &driver, KeymapKey &key, unsigned duration, unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+            EXPECT_REPORT(driver, (key.report_code));
+            EXPECT_EMPTY_REPORT(driver);
+            tap_key(key, duration);
+            idle_for(TAPPING_TERM);
+            VERIFY_AND_CLEAR(driver);
+        }
+    }
+
+    void train_chords(TestDriver &driver, KeymapKey &mod_tap_key, KeymapKey &other_key, unsigned gap, unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+            EXPECT_REPORT(driver, (KC_LSFT));
+            EXPECT_REPORT(driver, (KC_LSFT, other_key.report_code));
+            EXPECT_REPORT(driver, (KC_LSFT));
+            EXPECT_EMPTY_REPORT(driver);
+            mod_tap_key.press();
+            idle_for(gap);
+            other_key.press();
+            run_one_scan_loop();
+            other_key.release();
+            run_one_scan_loop();
+            mod_tap_key.release();
+            idle_for(TAPPING_TERM);
+            VERIFY_AND_CLEAR(driver);
+        }
+    }
+};
+
+TEST_F(PredictiveTapHold, hold_waits_for_tapping_term_without_statistics) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(PredictiveTapHold, hold_settles_early_after_consistently_short_taps) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    train_taps(driver, mod_tap_key, 50, PREDICTIVE_TAP_HOLD_MIN_SAMPLES);
+    const predictive_tap_hold_stats_t *stats = stats_for(mod_tap_key);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->taps, PREDICTIVE_TAP_HOLD_MIN_SAMPLES);
+    EXPECT_EQ(stats->tap_mean, 50 * 16);
+
+    // Taps are well below PREDICTIVE_TAP_HOLD_MIN_TERM, which becomes the tapping term
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(PREDICTIVE_TAP_HOLD_MIN_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // Released alone before the regular tapping term, the long press is learned as a tap
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(20);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats->taps, PREDICTIVE_TAP_HOLD_MIN_SAMPLES + 1);
+    EXPECT_GT(stats->tap_mean, 50 * 16);
+}
+
+TEST_F(PredictiveTapHold, early_hold_used_in_a_chord_is_kept) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_key, regular_key});
+
+    train_taps(driver, mod_tap_key, 50, PREDICTIVE_TAP_HOLD_MIN_SAMPLES);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(PREDICTIVE_TAP_HOLD_MIN_TERM + 10);
+    regular_key.press();
+    run_one_scan_loop();
+    regular_key.release();
+    run_one_scan_loop();
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    const predictive_tap_hold_stats_t *stats = stats_for(mod_tap_key);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->taps, PREDICTIVE_TAP_HOLD_MIN_SAMPLES);
+    EXPECT_EQ(stats->chords, 1);
+}
+
+TEST_F(PredictiveTapHold, fast_roll_settles_as_tap_on_press) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_key, regular_key});
+
+    // Shift is only ever used well after the tapping term
+    train_chords(driver, mod_tap_key, regular_key, TAPPING_TERM + 50, PREDICTIVE_TAP_HOLD_MIN_SAMPLES);
+
+    // A key pressed right after the mod-tap settles it as tapped immediately,
+    // rather than when the mod-tap is released
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    mod_tap_key.press();
+    idle_for(20);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(PredictiveTapHold, chord_before_learned_gap_still_waits) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_key, regular_key});
+
+    // Without enough samples, the default behavior applies
+    train_chords(driver, mod_tap_key, regular_key, TAPPING_TERM + 50, PREDICTIVE_TAP_HOLD_MIN_SAMPLES - 1);
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(20);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(PredictiveTapHold, restored_snapshot_applies_immediately) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    predictive_tap_hold_stats_t snapshot = {};
+    snapshot.key                         = mod_tap_key.position;
+    snapshot.tap_mean                    = 120 * 16;
+    snapshot.tap_deviation               = 5 * 16;
+    snapshot.taps                        = PREDICTIVE_TAP_HOLD_MIN_SAMPLES;
+    predictive_tap_hold_set_stats(&snapshot, 1);
+
+    // 120 + 3 * 5 ms
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(136);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,83 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class WaitingBuffer : public TestFixture {
+   public:
+    WaitingBuffer() {
+        waiting_buffer_reset_stats();
+    }
+};
+
+TEST_F(WaitingBuffer, events_beyond_default_size_are_kept) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key  = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    auto       regular_keys = std::vector<KeymapKey>{
+        KeymapKey(0, 1, 0, KC_A), KeymapKey(0, 2, 0, KC_B), KeymapKey(0, 3, 0, KC_C), KeymapKey(0, 4, 0, KC_D), KeymapKey(0, 5, 0, KC_E), KeymapKey(0, 6, 0, KC_F),
+    };
+
+    set_keymap({mod_tap_key, regular_keys[0], regular_keys[1], regular_keys[2], regular_keys[3], regular_keys[4], regular_keys[5]});
+
+    // 12 events are held back while the mod-tap key is undecided
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    for (auto &key : regular_keys) {
+        tap_key(key);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(waiting_buffer_get_stats().high_water, 12);
+    EXPECT_EQ(waiting_buffer_get_stats().overflows, 0);
+
+    // All of them are replayed once the mod-tap key settles as held
+    EXPECT_REPORT(driver, (KC_LSFT));
+    for (auto &key : regular_keys) {
+        EXPECT_REPORT(driver, (KC_LSFT, key.report_code));
+        EXPECT_REPORT(driver, (KC_LSFT));
+    }
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(WaitingBuffer, overflow_is_counted) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    auto       regular_key = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({mod_tap_key, regular_key});
+
+    EXPECT_ANY_REPORT(driver).Times(AnyNumber());
+    mod_tap_key.press();
+    run_one_scan_loop();
+    for (int i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        tap_key(regular_key);
+    }
+    mod_tap_key.release();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(waiting_buffer_get_stats().overflows, 1);
+    EXPECT_EQ(waiting_buffer_get_stats().high_water, WAITING_BUFFER_SIZE - 1);
+
+    waiting_buffer_reset_stats();
+    EXPECT_EQ(waiting_buffer_get_stats().overflows, 0);
+    EXPECT_EQ(waiting_buffer_get_stats().high_water, 0);
+}
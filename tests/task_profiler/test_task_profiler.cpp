@@ -0,0 +1,99 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "task_profiler.h"
+void advance_time(uint32_t ms);
+}
+
+/* ST7565 isn't enabled, so the main loop never touches this stage */
+static const task_profiler_stage_t stage = TASK_PROFILER_ST7565_TASK;
+
+class TaskProfiler : public TestFixture {
+   protected:
+    void SetUp() override {
+        task_profiler_reset();
+    }
+
+    void sample(uint32_t ms) {
+        task_profiler_begin(stage);
+        advance_time(ms);
+        task_profiler_end(stage);
+    }
+};
+
+TEST_F(TaskProfiler, uses_millisecond_fallback) {
+    EXPECT_EQ(task_profiler_unit(), TASK_PROFILER_UNIT_MS);
+}
+
+TEST_F(TaskProfiler, accumulates_samples) {
+    task_profiler_stats_t stats;
+
+    EXPECT_FALSE(task_profiler_get_stats(stage, &stats));
+
+    sample(4);
+    sample(2);
+    sample(6);
+    ASSERT_TRUE(task_profiler_get_stats(stage, &stats));
+    EXPECT_EQ(stats.samples, 3);
+    EXPECT_EQ(stats.min, 2);
+    EXPECT_EQ(stats.avg, 4);
+    EXPECT_EQ(stats.max, 6);
+    EXPECT_EQ(stats.p99, 6);
+    EXPECT_EQ(stats.max_ever, 6);
+}
+
+TEST_F(TaskProfiler, keeps_max_ever_after_ring_wraps) {
+    task_profiler_stats_t stats;
+
+    sample(20);
+    for (uint8_t i = 0; i < TASK_PROFILER_RING_SIZE; i++) {
+        sample(1);
+    }
+    ASSERT_TRUE(task_profiler_get_stats(stage, &stats));
+    EXPECT_EQ(stats.samples, TASK_PROFILER_RING_SIZE);
+    EXPECT_EQ(stats.max, 1);
+    EXPECT_EQ(stats.max_ever, 20);
+}
+
+TEST_F(TaskProfiler, reset_clears_all_stages) {
+    TestDriver            driver;
+    task_profiler_stats_t stats;
+
+    sample(3);
+    run_one_scan_loop();
+    ASSERT_TRUE(task_profiler_get_stats(stage, &stats));
+    ASSERT_TRUE(task_profiler_get_stats(TASK_PROFILER_MATRIX_TASK, &stats));
+
+    task_profiler_reset();
+    EXPECT_FALSE(task_profiler_get_stats(stage, &stats));
+    EXPECT_FALSE(task_profiler_get_stats(TASK_PROFILER_MATRIX_TASK, &stats));
+
+    sample(5);
+    ASSERT_TRUE(task_profiler_get_stats(stage, &stats));
+    EXPECT_EQ(stats.samples, 1);
+    EXPECT_EQ(stats.max_ever, 5);
+}
+
+TEST_F(TaskProfiler, answers_raw_hid_queries) {
+    uint8_t data[32] = {TASK_PROFILER_RAW_HID_ID, stage};
+
+    sample(7);
+    ASSERT_TRUE(task_profiler_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[1], stage);
+    EXPECT_EQ(data[2], TASK_PROFILER_STAGE_COUNT);
+    EXPECT_EQ(data[3] << 8 | data[4], 1); // samples
+    EXPECT_EQ(data[8], 7);                // min
+    EXPECT_EQ(data[24], 7);               // max_ever
+    EXPECT_EQ(data[25], TASK_PROFILER_UNIT_MS);
+
+    task_profiler_stats_t stats;
+    data[0] = TASK_PROFILER_RAW_HID_ID;
+    data[1] = 0xFF;
+    ASSERT_TRUE(task_profiler_raw_hid_receive(data, sizeof(data)));
+    EXPECT_FALSE(task_profiler_get_stats(stage, &stats));
+}
@@ -11,6 +11,9 @@
 
 #include "usb_driver.h"
 #include "util.h"
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    include "idle_sleep.h"
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
@@ -247,6 +250,12 @@ void usb_endpoint_out_rx_complete_cb(USBDriver *usbp, usbep_t ep) {
      * next transaction.*/
     usb_start_receive(endpoint);
 
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+    /* Wake the main loop so that the received data is handled now rather
+     * than after the idle sleep times out.*/
+    platform_idle_sleep_wakeup_i();
+#endif
+
     osalSysUnlockFromISR();
 }
 
@@ -25,6 +25,9 @@
 #    include "sleep_led.h"
 #    include "led.h"
 #endif
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    include "idle_sleep.h"
+#endif
 #include "wait.h"
 #include "usb_endpoints.h"
 #include "usb_device_state.h"
@@ -179,6 +182,12 @@ void usb_event_queue_task(void) {
 
 /* Handles the USB driver global events. */
 static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+    osalSysLockFromISR();
+    platform_idle_sleep_wakeup_i();
+    osalSysUnlockFromISR();
+#endif
+
     switch (event) {
         case USB_EVENT_ADDRESS:
             return;
@@ -256,6 +265,12 @@ static void set_led_transfer_cb(USBDriver *usbp) {
     } else {
         usb_device_state_set_leds(set_report_buf[0]);
     }
+
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+    osalSysLockFromISR();
+    platform_idle_sleep_wakeup_i();
+    osalSysUnlockFromISR();
+#endif
 }
 
 static bool usb_requests_hook_cb(USBDriver *usbp) {
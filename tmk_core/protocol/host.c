@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "scan_latency.h"
 #include "usb_device_state.h"
 
 #ifdef DIGITIZER_ENABLE
@@ -142,6 +143,7 @@ void host_keyboard_send(report_keyboard_t *report) {
     report->report_id = REPORT_ID_KEYBOARD;
 #endif
     (*driver->send_keyboard)(report);
+    SCAN_LATENCY_REPORT_SENT();
 
     if (debug_keyboard) {
         dprintf("keyboard_report: %02X | ", report->mods);
@@ -158,6 +160,7 @@ void host_nkro_send(report_nkro_t *report) {
 
     report->report_id = REPORT_ID_NKRO;
     (*driver->send_nkro)(report);
+    SCAN_LATENCY_REPORT_SENT();
 
     if (debug_keyboard) {
         dprintf("nkro_report: %02X | ", report->mods);